@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/SlabCache.h>
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/ShardedCounter.h>
+
+using namespace Afina::Concurrency;
+
+// Number of operations each thread performs
+static const std::size_t n_ops = 2000000;
+
+// Nodes shared by all threads in the free list workload
+static const std::size_t n_nodes = 4096;
+
+// Runs op(thread number) n_ops times in each of n_threads threads, returns operations per second
+static double run(std::size_t n_threads, std::function<void(std::size_t)> op) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_threads; i++) {
+        threads.emplace_back([&op, i] {
+            for (std::size_t j = 0; j < n_ops; j++) {
+                op(i);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return n_threads * n_ops / elapsed.count();
+}
+
+struct Node {
+    Node *next;
+};
+
+/**
+ * Free list guarded by a single mutex, as the simplest baseline
+ */
+class LockedFreeList {
+public:
+    void Push(Node *node) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        node->next = _head;
+        _head = node;
+    }
+
+    Node *Pop() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Node *node = _head;
+        if (node != nullptr) {
+            _head = node->next;
+        }
+        return node;
+    }
+
+private:
+    std::mutex _mutex;
+    Node *_head = nullptr;
+};
+
+// Per CPU lists without restartable sequences
+struct CoreFreeListSpin : public CoreFreeList<Node> {
+    CoreFreeListSpin() : CoreFreeList<Node>(false) {}
+};
+
+// Each operation takes node and puts it back
+template <typename List> static double freelist(std::size_t n_threads) {
+    List list;
+    std::vector<Node> nodes(n_nodes);
+    for (auto &node : nodes) {
+        list.Push(&node);
+    }
+    return run(n_threads, [&list](std::size_t) {
+        Node *node = list.Pop();
+        if (node != nullptr) {
+            list.Push(node);
+        }
+    });
+}
+
+int main(int argc, char **argv) {
+    std::cout << "restartable sequences " << (Rseq::Available() ? "available" : "not available") << std::endl;
+
+    using runner = std::function<double(std::size_t)>;
+    std::vector<std::pair<std::string, runner>> counters = {
+        {"atomic",
+         [](std::size_t n_threads) {
+             std::atomic<uint64_t> counter(0);
+             return run(n_threads, [&counter](std::size_t) { counter.fetch_add(1, std::memory_order_relaxed); });
+         }},
+        {"thread_local",
+         [](std::size_t n_threads) {
+             ShardedCounter counter;
+             return run(n_threads, [&counter](std::size_t) { counter.Add(); });
+         }},
+        {"core_atomic",
+         [](std::size_t n_threads) {
+             CoreCounter counter(false);
+             return run(n_threads, [&counter](std::size_t) { counter.Add(); });
+         }},
+        {"core_rseq",
+         [](std::size_t n_threads) {
+             CoreCounter counter;
+             return run(n_threads, [&counter](std::size_t) { counter.Add(); });
+         }},
+    };
+
+    std::vector<std::pair<std::string, runner>> lists = {
+        {"mutex", freelist<LockedFreeList>},
+        {"lock_free", freelist<Afina::Allocator::LockFreeStack<Node>>},
+        {"core_spin", freelist<CoreFreeListSpin>},
+        {"core_rseq", freelist<CoreFreeList<Node>>},
+    };
+
+    auto print = [](const std::string &workload, std::vector<std::pair<std::string, runner>> &impls) {
+        for (auto &impl : impls) {
+            for (std::size_t n_threads = 1; n_threads <= 16; n_threads *= 4) {
+                double ops = impl.second(n_threads);
+                std::cout << std::setw(10) << workload << std::setw(14) << impl.first << std::setw(10) << n_threads
+                          << std::setw(16) << std::fixed << std::setprecision(0) << ops << std::endl;
+            }
+        }
+    };
+
+    std::cout << std::setw(10) << "workload" << std::setw(14) << "impl" << std::setw(10) << "threads"
+              << std::setw(16) << "ops/sec" << std::endl;
+    print("counter", counters);
+    print("freelist", lists);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+using clock_type = std::chrono::steady_clock;
+
+// Number of tasks each producer submits in the external workload
+static const std::size_t n_tasks = 200000;
+
+// Number of threads submitting tasks from outside of the pool
+static const std::size_t n_producers = 2;
+
+// Depth of the task tree in the nested workload, gives 2^(depth+1)-1 tasks
+static const int tree_depth = 17;
+
+struct Result {
+    double tasks_per_sec;
+
+    // Delay between submit and start of the task, in microseconds
+    double p50, p99, p999;
+};
+
+static double percentile(std::vector<double> &sorted, double p) {
+    return sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(sorted.size() * p))];
+}
+
+/**
+ * Tasks are submitted by producers which are not pool threads, as network workers do. Each task records
+ * how long it has been waiting in the queue
+ */
+static Result external(Executor::Mode mode, std::size_t n_threads) {
+    Executor executor("bench", n_threads, n_threads, 1 << 16, std::chrono::milliseconds(1000), mode);
+    std::vector<double> delays(n_producers * n_tasks);
+    std::atomic<std::size_t> done(0);
+
+    auto producer = [&](std::size_t id) {
+        for (std::size_t i = 0; i < n_tasks; i++) {
+            double *slot = &delays[id * n_tasks + i];
+            auto submitted = clock_type::now();
+            auto task = [slot, submitted, &done] {
+                std::chrono::duration<double, std::micro> delay = clock_type::now() - submitted;
+                *slot = delay.count();
+                done.fetch_add(1, std::memory_order_relaxed);
+            };
+            while (!executor.Execute(task)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    auto start = clock_type::now();
+    std::vector<std::thread> producers;
+    for (std::size_t i = 0; i < n_producers; i++) {
+        producers.emplace_back(producer, i);
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    while (done.load() < delays.size()) {
+        std::this_thread::yield();
+    }
+    std::chrono::duration<double> elapsed = clock_type::now() - start;
+    executor.Stop(true);
+
+    std::sort(delays.begin(), delays.end());
+    return Result{delays.size() / elapsed.count(), percentile(delays, 0.5), percentile(delays, 0.99),
+                  percentile(delays, 0.999)};
+}
+
+static void spawn(Executor &executor, std::atomic<std::size_t> &done, int depth) {
+    if (depth > 0) {
+        for (int i = 0; i < 2; i++) {
+            while (!executor.Execute(spawn, std::ref(executor), std::ref(done), depth - 1)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Tasks are submitted by pool threads: each task splits itself into two until tree depth is reached
+ */
+static Result nested(Executor::Mode mode, std::size_t n_threads) {
+    Executor executor("bench", n_threads, n_threads, 1 << 20, std::chrono::milliseconds(1000), mode);
+    std::atomic<std::size_t> done(0);
+    const std::size_t total = (std::size_t(1) << (tree_depth + 1)) - 1;
+
+    auto start = clock_type::now();
+    executor.Execute(spawn, std::ref(executor), std::ref(done), tree_depth);
+    while (done.load() < total) {
+        std::this_thread::yield();
+    }
+    std::chrono::duration<double> elapsed = clock_type::now() - start;
+    executor.Stop(true);
+    return Result{total / elapsed.count(), 0, 0, 0};
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::pair<std::string, Executor::Mode>> modes = {
+        {"shared", Executor::Mode::kShared},
+        {"stealing", Executor::Mode::kStealing},
+    };
+    std::vector<std::pair<std::string, std::function<Result(Executor::Mode, std::size_t)>>> workloads = {
+        {"external", external},
+        {"nested", nested},
+    };
+
+    std::cout << std::setw(10) << "workload" << std::setw(10) << "mode" << std::setw(10) << "threads" << std::setw(14)
+              << "tasks/sec" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "p999 us"
+              << std::endl;
+    for (auto &w : workloads) {
+        for (auto &m : modes) {
+            for (std::size_t n_threads = 1; n_threads <= 8; n_threads *= 2) {
+                Result r = w.second(m.second, n_threads);
+                std::cout << std::setw(10) << w.first << std::setw(10) << m.first << std::setw(10) << n_threads
+                          << std::setw(14) << std::fixed << std::setprecision(0) << r.tasks_per_sec
+                          << std::setprecision(1) << std::setw(10) << r.p50 << std::setw(10) << r.p99
+                          << std::setw(10) << r.p999 << std::endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/AdaptiveMutex.h>
+
+using namespace Afina::Concurrency;
+
+// Number of critical sections each thread runs
+static const std::size_t n_ops = 1000000;
+
+// Shared state touched inside of the critical section, roughly the work of a storage lookup
+struct Shared {
+    uint64_t values[32] = {};
+};
+
+// Returns critical sections per second
+template <typename Lock> static double run(std::size_t n_threads, std::size_t work, Lock &lock) {
+    Shared shared;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_threads; i++) {
+        threads.emplace_back([&lock, &shared, work, i] {
+            for (std::size_t j = 0; j < n_ops; j++) {
+                std::lock_guard<Lock> guard(lock);
+                for (std::size_t k = 0; k < work; k++) {
+                    shared.values[(i + k) % 32] += j;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return n_threads * n_ops / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    std::cout << std::setw(14) << "lock" << std::setw(8) << "work" << std::setw(10) << "threads" << std::setw(16)
+              << "ops/sec" << std::setw(12) << "contended" << std::setw(10) << "parks" << std::setw(12)
+              << "wait ns" << std::setw(12) << "hold ns" << std::endl;
+
+    for (std::size_t work : {8, 256}) {
+        for (std::size_t n_threads = 1; n_threads <= 16; n_threads *= 4) {
+            std::mutex std_mutex;
+            double ops = run(n_threads, work, std_mutex);
+            std::cout << std::setw(14) << "std::mutex" << std::setw(8) << work << std::setw(10) << n_threads
+                      << std::setw(16) << std::fixed << std::setprecision(0) << ops << std::endl;
+
+            AdaptiveMutex adaptive;
+            ops = run(n_threads, work, adaptive);
+            LockStats stats = adaptive.Stats();
+            std::cout << std::setw(14) << "adaptive" << std::setw(8) << work << std::setw(10) << n_threads
+                      << std::setw(16) << ops << std::setw(12) << stats.contended << std::setw(10) << stats.parks
+                      << std::setw(12) << (stats.contended ? stats.wait_ns / stats.contended : 0) << std::setw(12)
+                      << (stats.hold_samples ? stats.hold_ns / stats.hold_samples : 0) << std::endl;
+        }
+    }
+    return 0;
+}
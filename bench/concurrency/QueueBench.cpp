@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/MPMCQueue.h>
+#include <afina/concurrency/SPSCQueue.h>
+
+using namespace Afina::Concurrency;
+
+// Number of elements each producer passes through the queue
+static const std::size_t n_items = 1000000;
+
+// Capacity of the bounded queues
+static const std::size_t capacity = 1024;
+
+/**
+ * Layout used by the code before lock-free queues: std::deque guarded by mutex
+ */
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : _capacity(capacity) {}
+
+    std::size_t TryPushBatch(uint64_t *values, std::size_t count) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        count = std::min(count, _capacity - _queue.size());
+        _queue.insert(_queue.end(), values, values + count);
+        return count;
+    }
+
+    std::size_t TryPopBatch(uint64_t *values, std::size_t count) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        count = std::min(count, _queue.size());
+        std::copy(_queue.begin(), _queue.begin() + count, values);
+        _queue.erase(_queue.begin(), _queue.begin() + count);
+        return count;
+    }
+
+private:
+    std::mutex _mutex;
+    std::deque<uint64_t> _queue;
+    std::size_t _capacity;
+};
+
+/**
+ * Passes n_items from each of the producers to consumers in batches of the given size and returns
+ * number of elements per second
+ */
+template <typename Queue>
+static double run(std::size_t n_producers, std::size_t n_consumers, std::size_t batch) {
+    Queue queue(capacity);
+    std::atomic<std::size_t> taken(0);
+    const std::size_t total = n_producers * n_items;
+
+    auto producer = [&] {
+        std::vector<uint64_t> values(batch, 1);
+        for (std::size_t i = 0; i < n_items;) {
+            std::size_t pushed = queue.TryPushBatch(values.data(), std::min(batch, n_items - i));
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            i += pushed;
+        }
+    };
+    auto consumer = [&] {
+        std::vector<uint64_t> values(batch);
+        while (taken.load(std::memory_order_relaxed) < total) {
+            std::size_t n = queue.TryPopBatch(values.data(), batch);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            taken.fetch_add(n, std::memory_order_relaxed);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_producers; i++) {
+        threads.emplace_back(producer);
+    }
+    for (std::size_t i = 0; i < n_consumers; i++) {
+        threads.emplace_back(consumer);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return total / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    using runner = std::function<double(std::size_t, std::size_t, std::size_t)>;
+    std::vector<std::pair<std::string, runner>> queues = {
+        {"locked", run<LockedQueue>},
+        {"mpmc", run<MPMCQueue<uint64_t>>},
+    };
+
+    std::cout << std::setw(10) << "queue" << std::setw(12) << "producers" << std::setw(12) << "consumers"
+              << std::setw(8) << "batch" << std::setw(16) << "items/sec" << std::endl;
+    auto print = [](const std::string &name, std::size_t p, std::size_t c, std::size_t batch, double result) {
+        std::cout << std::setw(10) << name << std::setw(12) << p << std::setw(12) << c << std::setw(8) << batch
+                  << std::setw(16) << std::fixed << std::setprecision(0) << result << std::endl;
+    };
+
+    for (std::size_t batch : {1, 16}) {
+        for (auto &q : queues) {
+            for (std::size_t n_threads = 1; n_threads <= 4; n_threads *= 2) {
+                print(q.first, n_threads, n_threads, batch, q.second(n_threads, n_threads, batch));
+            }
+        }
+        print("spsc", 1, 1, batch, run<SPSCQueue<uint64_t>>(1, 1, batch));
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "storage/HashIndex.h"
+#include "storage/SwissIndex.h"
+
+using namespace Afina::Backend;
+
+// Number of keys in the index
+static const std::size_t n_keys = 1000000;
+
+struct node {
+    std::string key;
+};
+
+struct node_equal {
+    bool operator()(const node &n, const std::string &key) const { return n.key == key; }
+};
+
+/**
+ * Index layout used by SimpleLRU before hash indexes, adapted to the HashIndex interface
+ */
+class MapIndex {
+public:
+    node *Find(const std::string &key, std::size_t) const {
+        auto it = _map.find(key);
+        return it == _map.end() ? nullptr : it->second;
+    }
+
+    void Insert(node *value, std::size_t) { _map.emplace(std::cref(value->key), value); }
+
+private:
+    std::map<std::reference_wrapper<const std::string>, node *, std::less<std::string>> _map;
+};
+
+// Runs given function for every key and returns average time in nanoseconds
+template <typename F> static double measure(const std::vector<std::string> &keys, F func) {
+    auto start = std::chrono::steady_clock::now();
+    for (auto &key : keys) {
+        func(key);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / keys.size();
+}
+
+template <typename Index>
+static void run(const std::string &name, std::vector<node> &nodes, const std::vector<std::string> &missing) {
+    std::hash<std::string> hasher;
+    Index index;
+    std::size_t found = 0;
+
+    std::vector<std::string> keys;
+    for (auto &n : nodes) {
+        keys.push_back(n.key);
+    }
+
+    std::size_t i = 0;
+    double insert = measure(keys, [&](const std::string &key) { index.Insert(&nodes[i++], hasher(key)); });
+    double hit = measure(keys, [&](const std::string &key) { found += index.Find(key, hasher(key)) != nullptr; });
+    double miss = measure(missing, [&](const std::string &key) { found += index.Find(key, hasher(key)) != nullptr; });
+
+    if (found != nodes.size()) {
+        std::cerr << name << ": wrong number of found keys " << found << std::endl;
+    }
+
+    std::cout << std::setw(12) << name << std::fixed << std::setprecision(1) << std::setw(12) << insert
+              << std::setw(12) << hit << std::setw(12) << miss << std::endl;
+}
+
+int main(int argc, char **argv) {
+    std::vector<node> nodes;
+    std::vector<std::string> missing;
+    for (std::size_t i = 0; i < n_keys; i++) {
+        nodes.push_back(node{"key_" + std::to_string(i * 7919 % n_keys)});
+        missing.push_back("missing_" + std::to_string(i));
+    }
+
+    std::cout << "ns/op for " << n_keys << " keys" << std::endl;
+    std::cout << std::setw(12) << "index" << std::setw(12) << "insert" << std::setw(12) << "hit" << std::setw(12)
+              << "miss" << std::endl;
+    run<MapIndex>("std::map", nodes, missing);
+    run<HashIndex<node, node_equal>>("robin_hood", nodes, missing);
+    run<SwissIndex<node, node_equal, SwissGroupScalar>>("swiss", nodes, missing);
+    run<SwissIndex<node, node_equal>>("swiss_simd", nodes, missing);
+    return 0;
+}
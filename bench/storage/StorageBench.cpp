@@ -0,0 +1,93 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/FlatCombineLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/ThreadSafeClock.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+
+// Number of distinct keys used by benchmark
+static const std::size_t n_keys = 100000;
+
+// Number of operations each thread performs
+static const std::size_t n_ops = 200000;
+
+// Percent of Get among all operations, could be changed by the first argument
+static std::size_t get_ratio = 95;
+
+static std::string make_key(std::size_t i) { return "key_" + std::to_string(i); }
+
+/**
+ * Runs mixed Get/Put workload on the given storage from n_threads threads and
+ * returns number of operations per second
+ */
+static double run(Storage &storage, std::size_t n_threads) {
+    for (std::size_t i = 0; i < n_keys; i++) {
+        storage.Put(make_key(i), "value");
+    }
+
+    auto worker = [&storage](std::size_t seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<std::size_t> key_dist(0, n_keys - 1);
+        std::uniform_int_distribution<std::size_t> op_dist(0, 99);
+
+        std::string value;
+        for (std::size_t i = 0; i < n_ops; i++) {
+            auto key = make_key(key_dist(gen));
+            if (op_dist(gen) < get_ratio) {
+                storage.Get(key, value);
+            } else {
+                storage.Put(key, "value");
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_threads; i++) {
+        threads.emplace_back(worker, i);
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return n_threads * n_ops / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    const std::size_t max_size = 64 * 1024 * 1024;
+    if (argc > 1) {
+        get_ratio = std::stoul(argv[1]);
+    }
+
+    std::vector<std::pair<std::string, std::function<std::unique_ptr<Storage>()>>> storages = {
+        {"mt_lru", [] { return std::unique_ptr<Storage>(new ThreadSafeSimplLRU(max_size)); }},
+        {"sharded_lru", [] { return std::unique_ptr<Storage>(new ShardedLRU(16, max_size)); }},
+        {"mt_clock", [] { return std::unique_ptr<Storage>(new ThreadSafeClock(max_size)); }},
+        {"fc_lru", [] { return std::unique_ptr<Storage>(new FlatCombineLRU(max_size)); }},
+    };
+
+    std::cout << get_ratio << "% of reads" << std::endl;
+    std::cout << std::setw(16) << "storage" << std::setw(10) << "threads" << std::setw(16) << "ops/sec" << std::endl;
+    for (auto &s : storages) {
+        for (std::size_t n_threads = 1; n_threads <= 8; n_threads *= 2) {
+            auto storage = s.second();
+            double ops = run(*storage, n_threads);
+            std::cout << std::setw(16) << s.first << std::setw(10) << n_threads << std::setw(16) << std::fixed
+                      << std::setprecision(0) << ops << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#ifndef AFINA_COUNTERS_H
+#define AFINA_COUNTERS_H
+
+#include <afina/concurrency/ShardedCounter.h>
+
+namespace Afina {
+
+/**
+ * # Server wide statistics
+ * Counters are updated on every request from all threads, so each one is sharded by threads and summed
+ * only when somebody asks for statistics, see Execute::Stats
+ */
+struct Counters {
+    // Commands received from clients
+    Concurrency::ShardedCounter requests;
+
+    // Keys found and not found by get commands
+    Concurrency::ShardedCounter get_hits;
+    Concurrency::ShardedCounter get_misses;
+
+    // Bytes received from and sent to clients
+    Concurrency::ShardedCounter bytes_read;
+    Concurrency::ShardedCounter bytes_written;
+
+    // Items removed by storage to free space for the new ones
+    Concurrency::ShardedCounter evictions;
+
+    // Instance shared by all services of the process
+    static Counters &Global() {
+        static Counters counters;
+        return counters;
+    }
+};
+
+} // namespace Afina
+
+#endif // AFINA_COUNTERS_H
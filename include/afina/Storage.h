@@ -1,12 +1,15 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <ctime>
 #include <string>
 
 namespace Afina {
 
 /**
- *
+ * # Key/value storage interface
+ * Each association could have expiration time. Once it passed storage must behave as if association
+ * doesn't exist anymore, but memory could be reclaimed later.
  */
 class Storage {
 public:
@@ -16,6 +19,9 @@ public:
     virtual void Start() {}
     virtual void Stop() {}
 
+    // Expiration time for Put which keeps deadline of the existing association, new one never expires
+    static constexpr std::time_t kKeepExpire = -1;
+
     /**
      * Stores association between given key/value pair.
      * If key is already present in storage then replace existing value by
@@ -27,8 +33,9 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire unix time when association expires, 0 means never, kKeepExpire keeps current one
      */
-    virtual bool Put(const std::string &key, const std::string &value) = 0;
+    virtual bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) = 0;
 
     /**
      * Stores association between given key/value pair if key isn't present in
@@ -40,8 +47,9 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire unix time when association expires, 0 means never
      */
-    virtual bool PutIfAbsent(const std::string &key, const std::string &value) = 0;
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) = 0;
 
     /**
      * Updates existing association between given key/value pair
@@ -53,8 +61,9 @@ public:
      *
      * @param key to be associated with value
      * @param value to be assigned for the key
+     * @param expire unix time when association expires, 0 means never
      */
-    virtual bool Set(const std::string &key, const std::string &value) = 0;
+    virtual bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) = 0;
 
     /**
      * Removes association for the given key
@@ -0,0 +1,94 @@
+#ifndef AFINA_ALLOCATOR_ARENA_H
+#define AFINA_ALLOCATOR_ARENA_H
+
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Bump pointer arena
+ * Takes memory from the system by large blocks and hands it out by moving pointer inside of the current
+ * block. Individual allocations are not returned, except the most recent one, instead all memory is
+ * released at once by Reset or destructor. Fits objects sharing the same lifetime: request parsing state,
+ * per-connection buffers and so on.
+ *
+ * Requests larger than a quarter of the block get their own block, so that current block isn't wasted.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class Arena {
+public:
+    Arena(std::size_t block_size = 64 * 1024);
+    ~Arena();
+
+    /**
+     * Returns memory block of the given size, throws std::bad_alloc if system is out of memory
+     *
+     * @param size number of bytes requested
+     * @param alignment power of two, at most alignof(std::max_align_t)
+     */
+    void *Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Memory is reused only if ptr is the most recent allocation, otherwise does nothing
+     *
+     * @param ptr block returned by Allocate
+     * @param size same as was requested from Allocate
+     */
+    void Free(void *ptr, std::size_t size);
+
+    /**
+     * Forgets all allocations, first bump block is kept for the future use, others and dedicated ones
+     * are released
+     */
+    void Reset();
+
+    // Number of bytes handed out since creation or last Reset
+    inline std::size_t Allocated() const { return _allocated; }
+
+    // Number of bytes taken from the system
+    inline std::size_t Footprint() const { return _footprint; }
+
+private:
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Header of each block taken from the system
+    struct Block {
+        Block *prev;
+
+        // Including header
+        std::size_t size;
+    };
+    static const std::size_t kHeaderSize;
+
+    // Take new block from the system able to fit given number of bytes, block isn't linked anywhere
+    Block *NewBlock(std::size_t size);
+
+    // Release given block and all linked behind it
+    void FreeBlocks(Block *block);
+
+    std::size_t _block_size;
+
+    // Last block used for bump allocation, older ones are linked behind it
+    Block *_blocks;
+
+    // Blocks of requests too large for bump allocation, newest first
+    Block *_dedicated;
+
+    // Free space of the current block
+    char *_pos;
+    char *_end;
+
+    // Most recent allocation, could be rolled back by Free
+    char *_last;
+
+    std::size_t _allocated;
+    std::size_t _footprint;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ARENA_H
@@ -0,0 +1,116 @@
+#ifndef AFINA_ALLOCATOR_MEM_POOL_H
+#define AFINA_ALLOCATOR_MEM_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <afina/allocator/SlabCache.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Pool of the fixed size objects
+ * Objects are cut from slabs taken from SlabCache. Free objects are kept in magazines: small arrays of
+ * pointers. Each thread owns two magazines per pool, so that most of Alloc/Free calls touch only thread
+ * local memory without any synchronization. Once both magazines of the thread are empty (or full), one of
+ * them is exchanged with the depot: lock-free stacks of full and empty magazines shared by all threads.
+ *
+ * Object could be freed by any thread, not only by the one allocated it. Memory is given back to the
+ * SlabCache only when pool is destroyed, so pool must outlive all objects and threads using it.
+ *
+ * Up to kMaxPools pools could exist at the same time.
+ */
+class MemPool {
+public:
+    // Number of objects in the magazine
+    static const std::size_t kMagazineSize = 32;
+
+    // Maximum number of pools alive at once
+    static const std::size_t kMaxPools = 64;
+
+    MemPool(std::size_t object_size, SlabCache &cache = SlabCache::Default());
+    ~MemPool();
+
+    /**
+     * Returns memory for one object, throws std::bad_alloc if system is out of memory
+     */
+    void *Alloc();
+
+    /**
+     * Returns memory of the object allocated by Alloc back to pool
+     */
+    void Free(void *ptr);
+
+    inline std::size_t ObjectSize() const { return _object_size; }
+
+    // Number of slabs taken by this pool
+    inline std::size_t Slabs() const { return _n_slabs.load(std::memory_order_relaxed); }
+
+private:
+    MemPool(const MemPool &) = delete;
+    MemPool &operator=(const MemPool &) = delete;
+
+    struct Magazine {
+        Magazine *next;
+
+        // All magazines of the pool, to release them on destruction
+        Magazine *all_next;
+
+        std::size_t count;
+        void *objects[kMagazineSize];
+    };
+
+    // Header in the beginning of each slab taken by the pool
+    struct Slab {
+        Slab *next;
+    };
+
+    // Magazines of a single thread for a single pool
+    struct ThreadMagazines {
+        MemPool *pool;
+        uint64_t generation;
+        Magazine *loaded;
+        Magazine *previous;
+    };
+
+    // All magazines of a thread, returned into depots on thread exit
+    struct ThreadCache {
+        ~ThreadCache();
+        ThreadMagazines pools[kMaxPools];
+    };
+
+    // Magazines of the calling thread for this pool
+    ThreadMagazines &Local();
+
+    // Empty magazine from the depot or new one
+    Magazine *TakeEmpty();
+
+    // Cut new slab onto objects, returns one full magazine and puts the rest into depot
+    Magazine *Refill();
+
+    // Return thread magazines into depot
+    void Flush(ThreadMagazines &local);
+
+    SlabCache &_cache;
+    const std::size_t _object_size;
+
+    // Slot in the registry of alive pools and thread caches
+    std::size_t _id;
+
+    // Distinguishes this pool from the previous ones had the same id
+    uint64_t _generation;
+
+    LockFreeStack<Magazine> _full;
+    LockFreeStack<Magazine> _empty;
+
+    std::atomic<Magazine *> _all_magazines;
+    LockFreeStack<Slab> _slabs;
+    std::atomic<std::size_t> _n_slabs;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEM_POOL_H
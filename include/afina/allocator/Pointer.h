@@ -7,6 +7,14 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * # Handle to the memory block of Simple allocator
+ * Pointer doesn't address memory directly, instead it refers to the slot in the allocator handle table
+ * which keeps current address of the block. So allocator is free to move blocks around, and all copies
+ * of the Pointer see the new address. Address returned by get() is valid only until next allocator call.
+ *
+ * Default constructed Pointer is empty, get() returns nullptr
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +25,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _handle == nullptr ? nullptr : *_handle; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **handle) : _handle(handle) {}
+
+    // Slot of the handle table, nullptr if pointer is empty
+    void **_handle;
 };
 
 } // namespace Allocator
@@ -1,6 +1,7 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
+#include <chrono>
 #include <string>
 #include <cstddef>
 
@@ -18,44 +19,138 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Blocks grow from the beginning of the area, each one starts with a header keeping its size, size of
+ * the previous block and the handle table slot. Handle table grows from the end of the area towards
+ * blocks. Space between last block and handle table is never split, it is consumed from the edge only.
+ *
+ * Freed block is merged with free neighbours and linked into free list, that is searched by first fit.
+ * Free block at the end of the blocks area is returned to the gap before handle table.
  */
-// TODO: Implements interface to allow usage as C++ allocators
+// Blocks are moved by defrag, so it can't back standard containers, see StlAllocator.h for that
 class Simple {
 public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes, throws AllocError with NoMemory type if there is no
+     * free space large enough. Doesn't move existing blocks, call defrag for that
+     *
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block, content is preserved up to the smaller of old and new sizes. Block is
+     * resized in place if possible, otherwise it moves and p keeps pointing to it. Empty p is allocated
+     * from scratch. On failure AllocError is thrown and block stays intact
+     *
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block, p becomes empty. Other copies of p must not be used anymore. Freeing empty
+     * Pointer does nothing, freeing Pointer which doesn't belong to the allocator throws AllocError
+     * with InvalidFree type
+     *
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all used blocks to the beginning of the area, so that whole free space is a single
+     * region. Handles are updated, so all Pointers remain valid
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Incremental version of defrag: continues compaction from the place where previous call stopped and
+     * returns once at least max_bytes are moved or max_time passed. Each step slides one used block over
+     * the free one before it, so any amount of work keeps allocator consistent. Returns true if there are
+     * no holes left
+     *
+     * @param max_bytes how many bytes could be moved by this call
+     * @param max_time how long this call could run
+     */
+    bool defrag(size_t max_bytes, std::chrono::microseconds max_time);
+
+    /**
+     * Returns share of free space which isn't available as a single block: 0 if all free memory is
+     * contiguous, close to 1 if it is split onto many small holes
+     */
+    double fragmentation() const;
+
+    /**
+     * Returns human readable description of the allocator state: list of blocks, totals, fragmentation
+     * and progress of incremental defrag
      */
     std::string dump() const;
 
 private:
+    struct Block;
+
+    static char *Payload(Block *block);
+    static Block *FromPayload(void *payload);
+
+    // Blocks surrounding given one, nullptr if there is no such block
+    Block *Next(Block *block) const;
+    Block *Prev(Block *block) const;
+
+    // Handle table management
+    void **TakeHandle();
+    void ReleaseHandle(void **handle);
+    bool IsHandle(void **handle) const;
+
+    // Free list management
+    void LinkFree(Block *block);
+    void UnlinkFree(Block *block);
+
+    // Find free block at least of the given size, it is unlinked from free list. nullptr if there is none
+    Block *TakeFree(size_t size);
+
+    // Cut new block of the given size from the gap before handle table, nullptr if it doesn't fit
+    Block *Carve(size_t size);
+
+    // Cut tail of the block if it is large enough to be a separate one, tail becomes free
+    void Split(Block *block, size_t size);
+
+    // Mark block as free and merge it with neighbours
+    void Release(Block *block);
+
+    // Moves incremental defrag cursor back to the block grown in place, if it pointed past its start
+    void KeepDefragCursor(Block *grown);
+
+    // Allocate block of the given size owned by the handle, nullptr if there is no space
+    Block *AllocBlock(size_t size, void **handle);
+
+    // Move used block following the free one to the free one place, returns moved block
+    Block *SlideOver(Block *hole);
+
     void *_base;
     const size_t _base_len;
+
+    // Blocks area is [_begin, _top), handle table is [_handles, _end)
+    char *_begin;
+    char *_top;
+    void **_handles;
+    void **_end;
+
+    // Block right before _top
+    Block *_last;
+
+    // Head of the free blocks list
+    Block *_free_blocks;
+
+    // Head of the unused handles list, each one keeps address of the next
+    void **_free_handles;
+
+    // There are no free blocks in [_begin, _defrag_cursor), incremental defrag continues from here
+    char *_defrag_cursor;
+
+    // Bytes moved by defrag since creation
+    size_t _defrag_moved;
 };
 
 } // namespace Allocator
@@ -0,0 +1,156 @@
+#ifndef AFINA_ALLOCATOR_SLAB_H
+#define AFINA_ALLOCATOR_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab class memory manager
+ * Memory is taken from the system by pages of the same size, each page is given to a single size class and
+ * cut onto equal chunks of that class. Chunk sizes grow geometrically, so internal fragmentation is bounded
+ * by the growth factor and objects of the close sizes share pages.
+ *
+ * Each class keeps pages having free chunks in a separate list, chunks freed inside of a page are linked
+ * into page own free list. Once page has no used chunks it leaves the class and goes into the shared pool
+ * of spare pages, so memory released by one class is reused by any other one. That way total number of
+ * pages follows amount of live data instead of the peak usage of each class. Owner which bounds its memory
+ * could also take page away from a class that still uses it: PickDonor lists chunks of the least used page,
+ * once they are freed page is given to the class which needs it.
+ *
+ * Requests larger than the biggest class go directly to the global operator new.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class Slab {
+public:
+    /**
+     * @param page_size size of the page, must be power of two
+     * @param growth_factor ratio between the chunk sizes of the neighbour classes
+     * @param max_spare_pages how many empty pages could be kept for the future use
+     */
+    Slab(std::size_t page_size = 64 * 1024, double growth_factor = 1.25, std::size_t max_spare_pages = 4);
+    ~Slab();
+
+    /**
+     * Returns memory block at least of the given size, throws std::bad_alloc if system is out of memory
+     *
+     * @param size number of bytes requested
+     */
+    void *Allocate(std::size_t size);
+
+    /**
+     * Returns memory block back to allocator
+     *
+     * @param ptr block returned by Allocate
+     * @param size exactly the same size as was requested from Allocate
+     */
+    void Free(void *ptr, std::size_t size);
+
+    /**
+     * Returns number of bytes block of the given size actually takes: chunk size of its class, or size itself
+     * for the large block
+     *
+     * @param size number of bytes requested
+     */
+    std::size_t BlockSize(std::size_t size) const;
+
+    /**
+     * Returns true if Allocate of the given size takes a new page from the system: class has no free chunk
+     * and there is no spare page
+     *
+     * @param size number of bytes requested
+     */
+    bool NeedsPage(std::size_t size) const;
+
+    /**
+     * Picks page of another class with the least used chunks, so that it could be reassigned to the class
+     * of the given size. Used chunks of that page are appended to chunks, once caller frees all of them
+     * page goes to the spare pool and next Allocate takes it. Returns false if there is no such page
+     *
+     * @param size number of bytes the page is needed for
+     * @param chunks output parameter for the used chunks of the page
+     */
+    bool PickDonor(std::size_t size, std::vector<void *> &chunks) const;
+
+    inline std::size_t PageSize() const { return _page_size; }
+
+    // Number of size classes
+    inline std::size_t Classes() const { return _classes.size(); }
+
+    // Chunk size of the given class
+    inline std::size_t ChunkSize(std::size_t cls) const { return _classes[cls].chunk_size; }
+
+    // Number of pages owned by the given class
+    inline std::size_t ClassPages(std::size_t cls) const { return _classes[cls].pages; }
+
+    // Number of pages owned by all classes
+    inline std::size_t Pages() const { return _pages; }
+
+    // Number of empty pages waiting for reuse
+    inline std::size_t SparePages() const { return _spare.size(); }
+
+    // Number of bytes taken from the system, both by pages and large blocks
+    inline std::size_t Footprint() const { return (_pages + _spare.size()) * _page_size + _large_bytes; }
+
+private:
+    Slab(const Slab &) = delete;
+    Slab &operator=(const Slab &) = delete;
+
+    // Header placed at the beginning of each page, chunks follow it
+    struct Page {
+        Page *prev;
+        Page *next;
+
+        // Chunks freed in this page
+        void *free_chunks;
+
+        // Chunks starting from this one were never used
+        char *unused;
+
+        uint32_t used;
+        uint32_t cls;
+    };
+
+    struct SizeClass {
+        std::size_t chunk_size;
+        uint32_t chunks_per_page;
+
+        // Pages having at least one free chunk and pages without any
+        Page *partial;
+        Page *full;
+
+        std::size_t pages;
+    };
+
+    static void Link(Page *&head, Page *page);
+    static void Unlink(Page *&head, Page *page);
+
+    // Index of the smallest class fitting given size
+    std::size_t ClassFor(std::size_t size) const;
+
+    // Take page from the pool or system and give it to the given class
+    Page *NewPage(std::size_t cls);
+
+    // Return empty page from its class into the pool
+    void ReleasePage(Page *page);
+
+    // Offset of the first chunk from the page start
+    std::size_t _header_size;
+    std::size_t _page_size;
+    std::size_t _max_spare_pages;
+
+    std::vector<SizeClass> _classes;
+    std::vector<Page *> _spare;
+
+    std::size_t _pages;
+    std::size_t _large_bytes;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_H
@@ -0,0 +1,108 @@
+#ifndef AFINA_ALLOCATOR_SLAB_CACHE_H
+#define AFINA_ALLOCATOR_SLAB_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Lock-free intrusive stack
+ * Node must have `Node *next` field. ABA problem is solved by the counter packed into the unused high bits
+ * of the head pointer, so nodes could be popped and pushed back concurrently. Popped node memory must stay
+ * readable while stack is in use: it is never returned to the system, only reused.
+ */
+template <typename Node> class LockFreeStack {
+public:
+    LockFreeStack() : _head(0) {}
+
+    void Push(Node *node) {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        do {
+            node->next = Ptr(head);
+        } while (!_head.compare_exchange_weak(head, Pack(node, Tag(head) + 1), std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    Node *Pop() {
+        uint64_t head = _head.load(std::memory_order_acquire);
+        Node *node;
+        do {
+            node = Ptr(head);
+            if (node == nullptr) {
+                return nullptr;
+            }
+            // Node could be taken by another thread right now, then value read here is junk but CAS fails
+        } while (!_head.compare_exchange_weak(head, Pack(__atomic_load_n(&node->next, __ATOMIC_RELAXED), Tag(head) + 1),
+                                              std::memory_order_acquire, std::memory_order_acquire));
+        return node;
+    }
+
+    // Takes all nodes at once, they remain linked through next
+    Node *PopAll() { return Ptr(_head.exchange(0, std::memory_order_acquire)); }
+
+private:
+    static_assert(sizeof(void *) == 8, "Pointer tagging requires 64 bit platform");
+
+    static const int kPtrBits = 48;
+    static const uint64_t kPtrMask = (uint64_t(1) << kPtrBits) - 1;
+
+    static inline Node *Ptr(uint64_t head) { return reinterpret_cast<Node *>(head & kPtrMask); }
+    static inline uint64_t Tag(uint64_t head) { return head >> kPtrBits; }
+    static inline uint64_t Pack(Node *node, uint64_t tag) {
+        return reinterpret_cast<uint64_t>(node) | (tag << kPtrBits);
+    }
+
+    std::atomic<uint64_t> _head;
+};
+
+/**
+ * # Source of the fixed size slabs
+ * Lowest level of the pool allocator: takes aligned slabs from the system and keeps slabs returned by
+ * pools for the reuse. Both operations are lock-free unless system has to be asked for memory. Slabs
+ * are released to the system only on destruction.
+ *
+ * Slab is aligned by its size, so the owner could find slab start from any address inside of it.
+ */
+class SlabCache {
+public:
+    SlabCache(std::size_t slab_size = 64 * 1024);
+    ~SlabCache();
+
+    /**
+     * Returns free slab, throws std::bad_alloc if system is out of memory
+     */
+    void *Get();
+
+    /**
+     * Returns slab back to the cache
+     */
+    void Put(void *slab);
+
+    inline std::size_t SlabSize() const { return _slab_size; }
+
+    // Number of slabs taken from the system
+    inline std::size_t Slabs() const { return _slabs.load(std::memory_order_relaxed); }
+
+    // Cache shared by pools which don't have own one
+    static SlabCache &Default();
+
+private:
+    SlabCache(const SlabCache &) = delete;
+    SlabCache &operator=(const SlabCache &) = delete;
+
+    struct FreeSlab {
+        FreeSlab *next;
+    };
+
+    const std::size_t _slab_size;
+    LockFreeStack<FreeSlab> _free;
+    std::atomic<std::size_t> _slabs;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_CACHE_H
@@ -0,0 +1,58 @@
+#ifndef AFINA_ALLOCATOR_STL_ALLOCATOR_H
+#define AFINA_ALLOCATOR_STL_ALLOCATOR_H
+
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Standard C++ allocator on the top of Afina memory source
+ * Lets standard containers take memory from Arena or Slab instead of the global heap:
+ *
+ *   Arena arena;
+ *   std::vector<int, StlAllocator<int, Arena>> v(StlAllocator<int, Arena>(arena));
+ *
+ * Source must provide Allocate(size) and Free(ptr, size), memory must be aligned at least for
+ * std::max_align_t. Adaptor doesn't own the source, so the source must outlive all containers using it.
+ * Copies of the adaptor, even rebound to other types, share the same source and compare equal.
+ *
+ * Simple allocator can't be used here as it moves blocks and standard containers keep raw pointers.
+ */
+template <typename T, typename Source> class StlAllocator {
+public:
+    using value_type = T;
+
+    template <typename U> struct rebind { using other = StlAllocator<U, Source>; };
+
+    explicit StlAllocator(Source &source) noexcept : _source(&source) {}
+
+    template <typename U> StlAllocator(const StlAllocator<U, Source> &other) noexcept : _source(other.source()) {}
+
+    T *allocate(std::size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned types are not supported");
+        return static_cast<T *>(_source->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept { _source->Free(p, n * sizeof(T)); }
+
+    inline Source *source() const noexcept { return _source; }
+
+private:
+    Source *_source;
+};
+
+template <typename T, typename U, typename Source>
+inline bool operator==(const StlAllocator<T, Source> &a, const StlAllocator<U, Source> &b) noexcept {
+    return a.source() == b.source();
+}
+
+template <typename T, typename U, typename Source>
+inline bool operator!=(const StlAllocator<T, Source> &a, const StlAllocator<U, Source> &b) noexcept {
+    return a.source() != b.source();
+}
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_STL_ALLOCATOR_H
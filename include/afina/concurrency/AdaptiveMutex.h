@@ -0,0 +1,207 @@
+#ifndef AFINA_CONCURRENCY_ADAPTIVE_MUTEX_H
+#define AFINA_CONCURRENCY_ADAPTIVE_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Contention statistics of a lock
+ */
+struct LockStats {
+    // Number of times lock was taken
+    uint64_t acquisitions = 0;
+
+    // How many of them found lock busy, and how many of those had to sleep in the kernel
+    uint64_t contended = 0;
+    uint64_t parks = 0;
+
+    // Total time spent waiting for the busy lock
+    uint64_t wait_ns = 0;
+
+    // Hold time is measured for one of kHoldSampleRate acquisitions only, so that clock isn't read on
+    // the fast path
+    uint64_t hold_samples = 0;
+    uint64_t hold_ns = 0;
+};
+
+/**
+ * # Spin then park mutex
+ * Busy lock is polled for a while first, since critical sections of a few hundred nanoseconds usually
+ * end sooner than the thread would fall asleep. If it is still busy thread parks on futex. Number of
+ * spins adapts to the lock: it follows the number of spins which were needed to take it recently, so
+ * lock held for long stops wasting CPU and short one rarely sleeps.
+ *
+ * Lock word is 0 when unlocked, 1 when locked and 2 when locked and somebody could sleep on it, so
+ * unlock makes a syscall only if there are sleepers.
+ *
+ * Follows std::mutex interface, so it could be used with std::lock_guard/std::unique_lock.
+ */
+class AdaptiveMutex {
+public:
+    // Upper bound of spins before park
+    static constexpr uint32_t kMaxSpins = 256;
+
+    // Hold time is measured once per that many acquisitions, must be a power of 2
+    static constexpr uint64_t kHoldSampleRate = 64;
+
+    AdaptiveMutex() : _state(0), _spins(kMaxSpins / 8), _hold_start(0) {}
+
+    void lock() {
+        uint32_t expected = 0;
+        if (!_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            LockSlow();
+        }
+        OnAcquire();
+    }
+
+    bool try_lock() {
+        uint32_t expected = 0;
+        if (!_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return false;
+        }
+        OnAcquire();
+        return true;
+    }
+
+    void unlock() {
+        if (_hold_start != 0) {
+            Add(_stats.hold_ns, Now() - _hold_start);
+            Add(_stats.hold_samples, 1);
+            _hold_start = 0;
+        }
+
+        if (_state.exchange(0, std::memory_order_release) == 2) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    /**
+     * Returns statistics collected so far. Could be called concurrently with lock users, fields are read
+     * one by one, so they could be slightly inconsistent with each other
+     */
+    LockStats Stats() const {
+        LockStats stats;
+        stats.acquisitions = _stats.acquisitions.load(std::memory_order_relaxed);
+        stats.contended = _stats.contended.load(std::memory_order_relaxed);
+        stats.parks = _stats.parks.load(std::memory_order_relaxed);
+        stats.wait_ns = _stats.wait_ns.load(std::memory_order_relaxed);
+        stats.hold_samples = _stats.hold_samples.load(std::memory_order_relaxed);
+        stats.hold_ns = _stats.hold_ns.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    AdaptiveMutex(const AdaptiveMutex &) = delete;
+    AdaptiveMutex &operator=(const AdaptiveMutex &) = delete;
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Lock word is used as futex");
+
+    static inline void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    static inline uint64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Statistics are updated by the lock holder only, so there is no need in atomic increments
+    static inline void Add(std::atomic<uint64_t> &field, uint64_t value) {
+        field.store(field.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline void OnAcquire() {
+        Add(_stats.acquisitions, 1);
+        if ((_stats.acquisitions.load(std::memory_order_relaxed) & (kHoldSampleRate - 1)) == 0) {
+            _hold_start = Now();
+        }
+    }
+
+    void LockSlow() {
+        uint64_t start = Now();
+
+        uint32_t limit = _spins.load(std::memory_order_relaxed) * 2 + 16;
+        if (limit > kMaxSpins) {
+            limit = kMaxSpins;
+        }
+
+        uint32_t spins = 0;
+        uint64_t parks = 0;
+        for (;;) {
+            if (spins < limit) {
+                spins++;
+                Pause();
+                uint32_t expected = 0;
+                if (_state.load(std::memory_order_relaxed) == 0 &&
+                    _state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;
+            }
+
+            // Lock is taken in state 2, since it isn't known if other threads sleep on it
+            if (_state.exchange(2, std::memory_order_acquire) == 0) {
+                break;
+            }
+            parks++;
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAIT_PRIVATE, 2, nullptr, nullptr, 0);
+        }
+
+        // Moving average of the spins needed, spins ran out if thread parked
+        uint32_t current = _spins.load(std::memory_order_relaxed);
+        uint32_t needed = spins;
+        if (parks > 0) {
+            needed = kMaxSpins;
+        }
+        _spins.store(current + (static_cast<int32_t>(needed - current) / 8), std::memory_order_relaxed);
+
+        Add(_stats.contended, 1);
+        Add(_stats.parks, parks);
+        Add(_stats.wait_ns, Now() - start);
+    }
+
+    struct Counters {
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> parks{0};
+        std::atomic<uint64_t> wait_ns{0};
+        std::atomic<uint64_t> hold_samples{0};
+        std::atomic<uint64_t> hold_ns{0};
+    };
+
+    std::atomic<uint32_t> _state;
+
+    // Average number of spins needed to take the lock, updated by holder
+    std::atomic<uint32_t> _spins;
+
+    // Start of the sampled hold, 0 if current one isn't sampled
+    uint64_t _hold_start;
+
+    Counters _stats;
+};
+
+/**
+ * Lock type of storage and connections, see CONCURRENCY_ADAPTIVE_MUTEX option
+ */
+#ifdef AFINA_ADAPTIVE_MUTEX
+using Mutex = AdaptiveMutex;
+#else
+using Mutex = std::mutex;
+#endif
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_ADAPTIVE_MUTEX_H
@@ -1,10 +1,213 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include <afina/concurrency/Rseq.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * # Per CPU value
+ * Keeps one instance of T for each possible CPU, each one on its own cache line. Unlike ThreadLocal
+ * number of instances doesn't depend on the number of threads, so it fits the case when there are many
+ * more threads, executor tasks or coroutines than cores.
+ *
+ * Thread could be migrated to another CPU at any moment, even right after Get returns, so instance could
+ * be accessed by several threads at once, although rarely. T must either be safe for concurrent access,
+ * or be modified only from the restartable sequences, see Rseq.h, CoreCounter and CoreFreeList below.
+ */
+template <typename T> class CoreLocal {
+public:
+    CoreLocal() : _size(Rseq::PossibleCpus()), _slots(nullptr) {
+        // C++11 new ignores over-alignment, so slots are placed into the aligned memory by hand
+        void *memory = nullptr;
+        if (posix_memalign(&memory, alignof(Slot), _size * sizeof(Slot)) != 0) {
+            throw std::bad_alloc();
+        }
+        _slots = static_cast<Slot *>(memory);
+
+        std::size_t i = 0;
+        try {
+            for (; i < _size; i++) {
+                new (&_slots[i]) Slot();
+            }
+        } catch (...) {
+            Destroy(i);
+            throw;
+        }
+    }
+
+    ~CoreLocal() { Destroy(_size); }
+
+    // Instance of the CPU current thread runs on
+    T &Get() { return _slots[Cpu()].value; }
+
+    // Instance of the given CPU
+    T &At(std::size_t cpu) { return _slots[cpu].value; }
+
+    // Number of instances
+    inline std::size_t Size() const { return _size; }
+
+    // CPU current thread runs on, always less than Size()
+    std::size_t Cpu() const {
+        int cpu = Rseq::CurrentCpu();
+        return cpu >= 0 && static_cast<std::size_t>(cpu) < _size ? cpu : 0;
+    }
+
+    template <typename F> void ForEach(F func) {
+        for (std::size_t i = 0; i < _size; i++) {
+            func(_slots[i].value);
+        }
+    }
+
+private:
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    // Destroys first n slots and releases memory
+    void Destroy(std::size_t n) {
+        for (std::size_t i = 0; i < n; i++) {
+            _slots[i].~Slot();
+        }
+        free(_slots);
+    }
+
+    const std::size_t _size;
+    Slot *_slots;
+};
+
+/**
+ * # Counter sharded by CPU
+ * With restartable sequences increment is a plain add on the cell of current CPU, without any lock
+ * prefix. Otherwise cell is incremented atomically: cell is shared only by threads of the same CPU, so
+ * cache line doesn't move between cores anyway.
+ */
+class CoreCounter {
+public:
+    explicit CoreCounter(bool use_rseq = Rseq::Available()) : _rseq(use_rseq) {
+        _cells.ForEach([](std::atomic<intptr_t> &cell) { cell.store(0, std::memory_order_relaxed); });
+    }
+
+    void Add(intptr_t n = 1) {
+        if (_rseq) {
+            for (;;) {
+                std::size_t cpu = _cells.Cpu();
+                if (Rseq::AddV(reinterpret_cast<intptr_t *>(&_cells.At(cpu)), n, cpu) == 0) {
+                    return;
+                }
+            }
+        }
+        _cells.Get().fetch_add(n, std::memory_order_relaxed);
+    }
+
+    intptr_t Read() {
+        intptr_t result = 0;
+        _cells.ForEach([&result](std::atomic<intptr_t> &cell) { result += cell.load(std::memory_order_relaxed); });
+        return result;
+    }
+
+private:
+    static_assert(sizeof(std::atomic<intptr_t>) == sizeof(intptr_t), "Cell is updated as plain integer");
+
+    const bool _rseq;
+    CoreLocal<std::atomic<intptr_t>> _cells;
+};
+
+/**
+ * # Free list sharded by CPU
+ * Intrusive stack of nodes for each CPU, Node must have `Node *next` field. Thread pushes and pops nodes
+ * on the list of its current CPU only, so the list is hot in the local cache. With restartable sequences
+ * both operations are a few plain loads and stores; pop reads next of the head inside of the sequence, so
+ * there is no ABA problem. Otherwise each list is guarded by its own spinlock.
+ */
+template <typename Node> class CoreFreeList {
+public:
+    explicit CoreFreeList(bool use_rseq = Rseq::Available()) : _rseq(use_rseq) {}
+
+    void Push(Node *node) {
+        if (_rseq) {
+            for (;;) {
+                std::size_t cpu = _lists.Cpu();
+                List &list = _lists.At(cpu);
+                Node *head = __atomic_load_n(&list.head, __ATOMIC_RELAXED);
+                node->next = head;
+                if (Rseq::CmpEqStoreV(reinterpret_cast<intptr_t *>(&list.head), reinterpret_cast<intptr_t>(head),
+                                      reinterpret_cast<intptr_t>(node), cpu) == 0) {
+                    return;
+                }
+            }
+        }
+
+        List &list = _lists.Get();
+        list.Lock();
+        node->next = list.head;
+        list.head = node;
+        list.Unlock();
+    }
+
+    // Takes node from the list of the current CPU, returns nullptr if that list is empty
+    Node *Pop() {
+        if (_rseq) {
+            for (;;) {
+                std::size_t cpu = _lists.Cpu();
+                intptr_t node;
+                int result = Rseq::CmpNeStoreOffpLoad(reinterpret_cast<intptr_t *>(&_lists.At(cpu).head), 0,
+                                                      offsetof(Node, next), &node, cpu);
+                if (result == 0) {
+                    return reinterpret_cast<Node *>(node);
+                } else if (result > 0) {
+                    return nullptr;
+                }
+            }
+        }
+
+        List &list = _lists.Get();
+        list.Lock();
+        Node *node = list.head;
+        if (node != nullptr) {
+            list.head = node->next;
+        }
+        list.Unlock();
+        return node;
+    }
+
+    /**
+     * Calls func for each node of all lists, must not run concurrently with Push or Pop
+     */
+    template <typename F> void ForEach(F func) {
+        _lists.ForEach([&func](List &list) {
+            for (Node *node = list.head; node != nullptr; node = node->next) {
+                func(node);
+            }
+        });
+    }
+
+private:
+    struct List {
+        Node *head = nullptr;
+        std::atomic<bool> locked{false};
+
+        void Lock() {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                sched_yield();
+            }
+        }
+        void Unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    const bool _rseq;
+    CoreLocal<List> _lists;
+};
 
 } // namespace Concurrency
 } // namespace Afina
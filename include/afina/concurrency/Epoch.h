@@ -0,0 +1,173 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Epoch based memory reclamation
+ * Lock-free reader could still hold pointer to the object which writer has just unlinked, so the object
+ * can't be freed right away. Reader pins the domain for the time it works with shared objects, see Guard,
+ * and pinned thread announces the global epoch it has observed. Writer unlinks the object and retires it,
+ * object is tagged by the current epoch and put into the retire list of the writer thread.
+ *
+ * Epoch advances only once every pinned thread has observed the current one, so after two advances
+ * there is no reader which could have seen an object retired before them, and the object is freed.
+ * That is done by Collect, either by background thread, see Start, or by writer itself. Retire never
+ * calls deleters, so writer could retire objects inside of its critical section and have them freed
+ * outside of it.
+ *
+ * Pin and unpin are a couple of atomic operations on the thread own state, readers never wait for each
+ * other or for writers. Stalled reader only delays freeing, memory grows until it unpins.
+ */
+class EpochDomain {
+    struct Participant;
+
+public:
+    // Frees retired object, context is the one given to Retire
+    using Deleter = void (*)(void *object, void *context);
+
+    /**
+     * # Pinned section
+     * Objects which were reachable when guard was created are not freed until it is destroyed. Guards
+     * could be nested, must be destroyed by the thread which created them
+     */
+    class Guard {
+    public:
+        Guard(Guard &&other) : _domain(other._domain), _participant(other._participant) {
+            other._participant = nullptr;
+        }
+        ~Guard() {
+            if (_participant != nullptr) {
+                _domain->Unpin(*_participant);
+            }
+        }
+
+    private:
+        friend class EpochDomain;
+        Guard(EpochDomain *domain, Participant *participant) : _domain(domain), _participant(participant) {}
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        EpochDomain *_domain;
+        Participant *_participant;
+    };
+
+    EpochDomain();
+
+    /**
+     * Stops background thread and frees all retired objects, no guards must be alive
+     */
+    ~EpochDomain();
+
+    /**
+     * Pins the current thread until returned guard is destroyed
+     */
+    Guard Pin();
+
+    /**
+     * Frees object once no reader could refer to it, see Collect. Object must be unreachable for new
+     * readers already
+     */
+    void Retire(void *object, Deleter deleter, void *context = nullptr);
+
+    // Same as above for object allocated by new
+    template <typename T> void Retire(T *object) { Retire(object, &DeleteObject<T>); }
+
+    /**
+     * Advances epoch if possible and frees objects retired by all threads which are safe to free.
+     * Returns number of freed objects
+     */
+    std::size_t Collect();
+
+    // Current global epoch
+    uint64_t Epoch() const { return _epoch.load(std::memory_order_relaxed); }
+
+    // Number of retired objects waiting to be freed
+    std::size_t Pending() const { return _pending.load(std::memory_order_relaxed); }
+
+    /**
+     * Spawns thread calling Collect once per tick, so that objects are freed even if writers stop
+     * retiring new ones. Does nothing if thread is running already
+     */
+    void Start(std::chrono::milliseconds tick = std::chrono::milliseconds(10));
+
+    /**
+     * Signals background thread to stop and waits until it exits
+     */
+    void Stop();
+
+private:
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    struct Retired {
+        void *object;
+        Deleter deleter;
+        void *context;
+
+        // Global epoch at the moment of retire
+        uint64_t epoch;
+    };
+
+    struct Participant {
+        // Epoch observed by the pinned thread shifted left by one with the lowest bit set, 0 if thread
+        // isn't pinned
+        std::atomic<uint64_t> state{0};
+
+        // Number of alive guards, used by owner thread only
+        std::size_t depth = 0;
+
+        // Protects retired, owner appends there and any Collect takes from there
+        std::mutex mutex;
+        std::vector<Retired> retired;
+    };
+
+    template <typename T> static void DeleteObject(void *object, void *) { delete static_cast<T *>(object); }
+
+    void Unpin(Participant &participant);
+
+    // Moves epoch one step forward if all pinned threads have observed the current one
+    void TryAdvance();
+
+    // Moves objects safe to free at the given epoch from retired into out
+    static void TakeSafe(std::vector<Retired> &retired, uint64_t epoch, std::vector<Retired> &out);
+
+    // Calls deleters, returns number of freed objects
+    std::size_t Free(std::vector<Retired> &objects);
+
+    // Method executing by background thread
+    void OnRun(std::chrono::milliseconds tick);
+
+    std::atomic<uint64_t> _epoch;
+    std::atomic<std::size_t> _pending;
+
+    // Objects retired by threads which have exited already
+    std::mutex _orphans_mutex;
+    std::vector<Retired> _orphans;
+
+    ThreadLocal<Participant> _participants;
+
+    // Protects _running and used to wakeup background thread on stop
+    std::mutex _mutex;
+    std::condition_variable _stop_condition;
+    bool _running;
+    std::thread _thread;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
@@ -1,21 +1,48 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace Afina {
 namespace Concurrency {
 
+class Executor;
+
+// See Executor::perform
+void perform(Executor *executor);
+
+// See Executor::perform_stealing
+void perform_stealing(Executor *executor, std::size_t index);
+
 /**
  * # Thread pool
+ * Keeps at least low_watermark threads alive. New thread is spawned when task arrives and there is no idle
+ * one, up to high_watermark threads. Thread above low watermark exits once it stays idle for idle_time.
+ *
+ * Queue is bounded: once it holds max_queue_size tasks, Execute rejects new ones, so that caller could
+ * fallback to running task by itself instead of accumulating unbounded backlog.
+ *
+ * Pool works in one of two modes:
+ * - kShared: all threads take tasks from the single queue guarded by mutex
+ * - kStealing: pool has exactly high_watermark threads, each one owns a work stealing deque. Task
+ *   submitted by pool thread goes to its own deque without any locks, task submitted from outside goes
+ *   to the shared injection queue and is moved to some thread deque in batches. Thread out of work steals
+ *   from random victims before it parks. Watermarks and idle time don't apply, threads never exit
+ *   until Stop
  */
 class Executor {
+public:
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -28,7 +55,24 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
+    enum class Mode {
+        // Single queue shared by all threads
+        kShared,
+
+        // Per thread deques with work stealing
+        kStealing
+    };
+
+    /**
+     * @param name used for diagnostic only
+     * @param low_watermark number of threads kept alive even if there are no tasks
+     * @param high_watermark maximum number of threads
+     * @param max_queue_size maximum number of tasks waiting for execution
+     * @param idle_time how long thread above low watermark waits for task before exit
+     * @param mode how tasks are distributed among threads
+     */
+    Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark, std::size_t max_queue_size,
+             std::chrono::milliseconds idle_time, Mode mode = Mode::kShared);
     ~Executor();
 
     /**
@@ -49,18 +93,33 @@ class Executor {
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
         // Prepare "task"
         auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
+        if (mode == Mode::kStealing) {
+            return Submit(exec);
+        }
 
         std::unique_lock<std::mutex> lock(this->mutex);
-        if (state != State::kRun) {
+        if (state != State::kRun || tasks.size() >= max_queue_size) {
             return false;
         }
 
         // Enqueue new task
+        // Idle thread notified before might not have woken up yet, so pool grows as soon as queued
+        // tasks outnumber idle threads
         tasks.push_back(exec);
-        empty_condition.notify_one();
+        if (tasks.size() > idle_threads && threads < high_watermark) {
+            StartThread();
+        } else {
+            empty_condition.notify_one();
+        }
         return true;
     }
 
+    // Number of alive threads
+    std::size_t Threads();
+
+    // Number of tasks waiting for execution
+    std::size_t QueueSize();
+
 private:
     // No copy/move/assign allowed
     Executor(const Executor &);            // = delete;
@@ -73,6 +132,26 @@ private:
      */
     friend void perform(Executor *executor);
 
+    /**
+     * Main function of the kStealing mode threads, index is the number of thread own deque
+     */
+    friend void perform_stealing(Executor *executor, std::size_t index);
+
+    // Spawn one more thread, mutex must be held
+    void StartThread();
+
+    // Account exit of the current thread, mutex must be held
+    void StopThread();
+
+    // kStealing mode: enqueue task without touching mutex unless some thread is parked
+    bool Submit(std::function<void()> task);
+
+    // kStealing mode: find task for the given thread in its deque, injection queue or other deques
+    std::function<void()> *TakeTask(std::size_t index);
+
+    // kStealing mode: wake up one parked thread if any
+    void Unpark();
+
     /**
      * Mutex to protect state below from concurrent modification
      */
@@ -84,9 +163,28 @@ private:
     std::condition_variable empty_condition;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await all threads stopped
      */
-    std::vector<std::thread> threads;
+    std::condition_variable stop_condition;
+
+    /**
+     * Pool configuration, see constructor
+     */
+    const std::string name;
+    const std::size_t low_watermark;
+    const std::size_t high_watermark;
+    const std::size_t max_queue_size;
+    const std::chrono::milliseconds idle_time;
+
+    /**
+     * Number of threads that perform execution, threads are detached and exit by themselves
+     */
+    std::size_t threads;
+
+    /**
+     * Number of threads waiting for task
+     */
+    std::size_t idle_threads;
 
     /**
      * Task queue
@@ -94,9 +192,32 @@ private:
     std::deque<std::function<void()>> tasks;
 
     /**
-     * Flag to stop bg threads
+     * Flag to stop bg threads, checked without mutex in kStealing mode
+     */
+    std::atomic<State> state;
+
+    const Mode mode;
+
+    /**
+     * kStealing mode: per thread deques, defined in Executor.cpp
+     */
+    struct Worker;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /**
+     * kStealing mode: tasks submitted by threads not belonging to the pool
+     */
+    std::mutex inject_mutex;
+    std::deque<std::function<void()> *> injected;
+    std::atomic<std::size_t> injected_size;
+
+    /**
+     * kStealing mode: number of tasks enqueued but not taken yet, and number of parked threads. Thread
+     * parks only after it has seen no pending tasks while registered as a sleeper, and submitter checks
+     * sleepers after it has counted its task, so that wakeup is never lost
      */
-    State state;
+    std::atomic<std::size_t> pending;
+    std::atomic<std::size_t> sleepers;
 };
 
 } // namespace Concurrency
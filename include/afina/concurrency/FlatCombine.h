@@ -1,10 +1,147 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Serializes operations over a non thread safe structure. Instead of taking the lock for each operation,
+ * thread publishes its operation in the publication slot and waits. Whoever gets the lock becomes the
+ * combiner: it walks over all slots and applies every pending operation, then hands results back by
+ * marking slots done. That way structure stays in the cache of a single core for the whole batch, and
+ * under contention each lock acquisition serves many threads instead of one.
+ *
+ * Op must have `void Execute()` method, it is called by the combiner thread. Exception thrown by Execute
+ * is rethrown by Apply in the thread that published the operation.
+ *
+ * Slots are not bound to threads forever: thread takes free slot for the duration of the single Apply,
+ * starting from the one it used last time, so any number of threads could share kSlots slots.
+ */
+template <typename Op> class FlatCombine {
+public:
+    // Number of publication slots
+    static const std::size_t kSlots = 64;
+
+    // How many times combiner walks over slots before it gives the lock up
+    static const int kCombineRounds = 4;
+
+    FlatCombine() : _lock(false), _used(0) {
+        for (auto &slot : _slots) {
+            slot.state.store(kFree, std::memory_order_relaxed);
+            slot.op = nullptr;
+        }
+    }
+
+    /**
+     * Executes operation, returns once it is done either by this thread or by another one
+     */
+    void Apply(Op &op) {
+        Slot &slot = Acquire();
+        slot.op = &op;
+        slot.error = nullptr;
+        slot.state.store(kPending, std::memory_order_release);
+
+        for (unsigned spins = 0; slot.state.load(std::memory_order_acquire) != kDone; spins++) {
+            if (!_lock.load(std::memory_order_relaxed) && !_lock.exchange(true, std::memory_order_acquire)) {
+                Combine();
+                _lock.store(false, std::memory_order_release);
+            } else if (spins > 64) {
+                // Combiner could be preempted, don't burn its time slice
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr error = slot.error;
+        slot.state.store(kFree, std::memory_order_release);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    FlatCombine(const FlatCombine &) = delete;
+    FlatCombine &operator=(const FlatCombine &) = delete;
+
+    enum State { kFree, kClaimed, kPending, kDone };
+
+    // Each slot is on its own cache line, so that publishing threads don't disturb each other
+    struct alignas(64) Slot {
+        std::atomic<int> state;
+        Op *op;
+        std::exception_ptr error;
+    };
+
+    static std::size_t &LastSlot() {
+        static thread_local std::size_t last = kSlots;
+        return last;
+    }
+
+    // Take free slot, preferably the same one as last time
+    Slot &Acquire() {
+        std::size_t &last = LastSlot();
+        if (last >= kSlots) {
+            static std::atomic<std::size_t> next_thread(0);
+            last = next_thread.fetch_add(1, std::memory_order_relaxed) % kSlots;
+        }
+
+        for (std::size_t i = 0;; i++) {
+            std::size_t pos = (last + i) % kSlots;
+            int expected = kFree;
+            if (_slots[pos].state.load(std::memory_order_relaxed) == kFree &&
+                _slots[pos].state.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire)) {
+                last = pos;
+
+                // Combiner checks slots below high watermark only
+                std::size_t used = _used.load(std::memory_order_relaxed);
+                while (used <= pos && !_used.compare_exchange_weak(used, pos + 1, std::memory_order_release)) {
+                }
+                return _slots[pos];
+            }
+            if (i % kSlots == kSlots - 1) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Apply pending operations, lock must be held
+    void Combine() {
+        for (int round = 0; round < kCombineRounds; round++) {
+            bool found = false;
+            const std::size_t used = _used.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < used; i++) {
+                Slot &slot = _slots[i];
+                if (slot.state.load(std::memory_order_acquire) != kPending) {
+                    continue;
+                }
+
+                try {
+                    slot.op->Execute();
+                } catch (...) {
+                    slot.error = std::current_exception();
+                }
+                slot.state.store(kDone, std::memory_order_release);
+                found = true;
+            }
+            if (!found) {
+                break;
+            }
+        }
+    }
+
+    // Combiner lock
+    alignas(64) std::atomic<bool> _lock;
+
+    // Slots at and above this position were never used
+    std::atomic<std::size_t> _used;
+
+    Slot _slots[kSlots];
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,193 @@
+#ifndef AFINA_CONCURRENCY_MPMC_QUEUE_H
+#define AFINA_CONCURRENCY_MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Bounded multi producer multi consumer queue
+ * Ring of cells, each one has a sequence number telling whether cell is ready to be written or read at the
+ * given position. Producers and consumers claim positions by CAS on their own counter and then work with
+ * claimed cells independently, so they meet only on the cells themselves. Neither operation blocks: it
+ * fails immediately if the queue is full or empty.
+ *
+ * Batch operations claim a run of ready cells with a single CAS, so the shared counters are touched once
+ * per batch instead of once per element.
+ *
+ * T must be default constructible and move assignable, capacity is rounded up to a power of two.
+ */
+template <typename T> class MPMCQueue {
+public:
+    explicit MPMCQueue(std::size_t capacity) : _enqueue_pos(0), _dequeue_pos(0) {
+        if (capacity < 2) {
+            throw std::runtime_error("Queue capacity must be at least 2");
+        }
+
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Adds element to the queue, returns false if queue is full. Element is moved only on success
+     */
+    bool TryPush(T &&value) {
+        std::size_t pos;
+        Cell *cell = Claim(_enqueue_pos, 0, pos);
+        if (cell == nullptr) {
+            return false;
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T &value) {
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    /**
+     * Takes the oldest element, returns false if queue is empty
+     */
+    bool TryPop(T &value) {
+        std::size_t pos;
+        Cell *cell = Claim(_dequeue_pos, 1, pos);
+        if (cell == nullptr) {
+            return false;
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Moves up to count elements from the given array into the queue, returns how many of them were added.
+     * Elements are added in order, all of them are next to each other in the queue
+     */
+    std::size_t TryPushBatch(T *values, std::size_t count) {
+        std::size_t pos;
+        std::size_t claimed = ClaimBatch(_enqueue_pos, 0, count, pos);
+        for (std::size_t i = 0; i < claimed; i++) {
+            Cell &cell = _cells[(pos + i) & _mask];
+            cell.value = std::move(values[i]);
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    /**
+     * Takes up to count oldest elements into the given array, returns how many of them were taken
+     */
+    std::size_t TryPopBatch(T *values, std::size_t count) {
+        std::size_t pos;
+        std::size_t claimed = ClaimBatch(_dequeue_pos, 1, count, pos);
+        for (std::size_t i = 0; i < claimed; i++) {
+            Cell &cell = _cells[(pos + i) & _mask];
+            values[i] = std::move(cell.value);
+            cell.sequence.store(pos + i + _mask + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Approximate number of elements
+    std::size_t Size() const {
+        std::size_t head = _dequeue_pos.load(std::memory_order_relaxed);
+        std::size_t tail = _enqueue_pos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    inline std::size_t Capacity() const { return _mask + 1; }
+
+private:
+    MPMCQueue(const MPMCQueue &) = delete;
+    MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+    struct Cell {
+        // Equals to position for the empty cell waiting for a producer, position + 1 for the full cell
+        // waiting for a consumer
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    /**
+     * Claims one position from the given counter. Cell at position is ready once its sequence is position
+     * plus shift: shift is 0 for producers and 1 for consumers. Returns nullptr if cell at the current
+     * position is not ready, i.e queue is full or empty
+     */
+    Cell *Claim(std::atomic<std::size_t> &counter, std::size_t shift, std::size_t &pos) {
+        pos = counter.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell *cell = &_cells[pos & _mask];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + shift));
+            if (diff == 0) {
+                if (counter.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return cell;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = counter.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Same as Claim, but takes the longest run of ready cells not exceeding count. Cells of the run can't
+     * change state until counter passes them, so it is enough to check them before CAS
+     */
+    std::size_t ClaimBatch(std::atomic<std::size_t> &counter, std::size_t shift, std::size_t count,
+                           std::size_t &pos) {
+        pos = counter.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t ready = 0;
+            bool moved = false;
+            while (ready < count) {
+                std::size_t seq = _cells[(pos + ready) & _mask].sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - (pos + ready + shift));
+                if (diff != 0) {
+                    // Cell ahead of position means somebody has claimed it already, start over
+                    moved = diff > 0;
+                    break;
+                }
+                ready++;
+            }
+
+            if (ready == 0) {
+                if (!moved) {
+                    return 0;
+                }
+                pos = counter.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (counter.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                return ready;
+            }
+        }
+    }
+
+    std::size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+
+    // Producers and consumers work with different counters, keep them on separate cache lines
+    alignas(64) std::atomic<std::size_t> _enqueue_pos;
+    alignas(64) std::atomic<std::size_t> _dequeue_pos;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_MPMC_QUEUE_H
@@ -0,0 +1,188 @@
+#ifndef AFINA_CONCURRENCY_PROFILED_MUTEX_H
+#define AFINA_CONCURRENCY_PROFILED_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Contention profile of the named lock
+ * Keeps number of acquisitions, how many of them found lock busy, and histograms of wait and hold
+ * times. All locks created with the same name share the profile, e.g. all storage shards or all
+ * connections. Profiles are updated by ProfiledMutex only while profiling is enabled, see Enable.
+ *
+ * Each thread updates its own shard of the profile, so profiling doesn't add contention by itself.
+ */
+class LockProfile {
+public:
+    // Bucket i of histogram counts durations in [2^i, 2^(i+1)) nanoseconds, the last one has no upper bound
+    static constexpr std::size_t kBuckets = 32;
+
+    struct Snapshot {
+        std::string name;
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+
+        // Total time spent waiting for the busy lock and holding it
+        uint64_t wait_ns = 0;
+        uint64_t hold_ns = 0;
+
+        uint64_t wait_hist[kBuckets] = {};
+        uint64_t hold_hist[kBuckets] = {};
+
+        // Upper bound of the bucket where given fraction of samples is reached, 0 if there are no samples
+        static uint64_t Percentile(const uint64_t *hist, double fraction);
+    };
+
+    /**
+     * Returns profile with the given name, creates it on the first call. Profile lives until the process
+     * exits
+     */
+    static LockProfile &Get(const std::string &name);
+
+    // Snapshots of all profiles ordered by name
+    static std::vector<Snapshot> ReadAll();
+
+    // Turns profiling of all locks on or off, it is off by default
+    static void Enable(bool enabled) { Enabled().store(enabled, std::memory_order_relaxed); }
+
+    static inline bool IsEnabled() { return Enabled().load(std::memory_order_relaxed); }
+
+    void OnAcquire(bool contended, uint64_t wait_ns) {
+        Shard &shard = _shards.Get();
+        Add(shard.acquisitions, 1);
+        if (contended) {
+            Add(shard.contended, 1);
+            Add(shard.wait_ns, wait_ns);
+            Add(shard.wait_hist[Bucket(wait_ns)], 1);
+        }
+    }
+
+    void OnRelease(uint64_t hold_ns) {
+        Shard &shard = _shards.Get();
+        Add(shard.hold_ns, hold_ns);
+        Add(shard.hold_hist[Bucket(hold_ns)], 1);
+    }
+
+    Snapshot Read();
+
+private:
+    explicit LockProfile(const std::string &name);
+
+    LockProfile(const LockProfile &) = delete;
+    LockProfile &operator=(const LockProfile &) = delete;
+
+    // Not over-aligned, since C++11 allocator ignores that. Shard spans several cache lines anyway
+    struct Shard {
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> wait_ns{0};
+        std::atomic<uint64_t> hold_ns{0};
+        std::atomic<uint64_t> wait_hist[kBuckets]{};
+        std::atomic<uint64_t> hold_hist[kBuckets]{};
+    };
+
+    static std::atomic<bool> &Enabled() {
+        static std::atomic<bool> enabled(false);
+        return enabled;
+    }
+
+    // Shard is written by its own thread only, so there is no need for atomic increment
+    static inline void Add(std::atomic<uint64_t> &field, uint64_t n) {
+        field.store(field.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static inline std::size_t Bucket(uint64_t ns) {
+        std::size_t bucket = 63 - __builtin_clzll(ns | 1);
+        return bucket < kBuckets ? bucket : kBuckets - 1;
+    }
+
+    // Adds shard into snapshot
+    static void Merge(Snapshot &snapshot, const Shard &shard);
+
+    const std::string _name;
+
+    // Sum of the shards of exited threads, guarded by the ThreadLocal lock
+    Snapshot _retired;
+
+    ThreadLocal<Shard> _shards;
+};
+
+/**
+ * # Mutex with contention profile
+ * Wraps any lock with std::mutex interface and reports its acquisitions and wait/hold times into the
+ * named LockProfile. While profiling is disabled the only cost is the check of a global flag.
+ */
+template <typename Lock = std::mutex> class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const std::string &name) : _profile(LockProfile::Get(name)), _hold_start(0) {}
+
+    void lock() {
+        if (!LockProfile::IsEnabled()) {
+            _lock.lock();
+            return;
+        }
+
+        bool contended = false;
+        uint64_t start = 0;
+        if (!_lock.try_lock()) {
+            contended = true;
+            start = Now();
+            _lock.lock();
+        }
+
+        uint64_t now = Now();
+        _profile.OnAcquire(contended, contended ? now - start : 0);
+        _hold_start = now;
+    }
+
+    bool try_lock() {
+        if (!_lock.try_lock()) {
+            return false;
+        }
+        if (LockProfile::IsEnabled()) {
+            _profile.OnAcquire(false, 0);
+            _hold_start = Now();
+        }
+        return true;
+    }
+
+    void unlock() {
+        // Hold started while profiling was enabled is measured even if it was disabled since then
+        if (_hold_start != 0) {
+            _profile.OnRelease(Now() - _hold_start);
+            _hold_start = 0;
+        }
+        _lock.unlock();
+    }
+
+private:
+    ProfiledMutex(const ProfiledMutex &) = delete;
+    ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+    static inline uint64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    Lock _lock;
+    LockProfile &_profile;
+
+    // Start of the current hold, 0 if it isn't measured. Accessed by lock holder only
+    uint64_t _hold_start;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_PROFILED_MUTEX_H
@@ -0,0 +1,161 @@
+#ifndef AFINA_CONCURRENCY_RSEQ_H
+#define AFINA_CONCURRENCY_RSEQ_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sched.h>
+#include <unistd.h>
+
+// Restartable sequences are registered by glibc 2.35+ for each thread, critical sections below are
+// written for x86_64 only
+#if defined(__linux__) && defined(__x86_64__) && defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define AFINA_RSEQ 1
+#endif
+#endif
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Restartable sequences
+ * Kernel keeps id of the CPU thread runs on in the memory area registered by thread, so it could be read
+ * without syscall. Short critical section which works with per CPU data is registered in the same area:
+ * if thread is preempted, migrated or gets a signal inside of the section, kernel moves it to the abort
+ * handler instead of resuming. So section could use plain loads and stores on data of the current CPU,
+ * its only store is the last instruction and either happens on the right CPU or doesn't happen at all.
+ *
+ * Each operation returns 0 on success and -1 if it was aborted, caller should read CPU id once again and
+ * retry. If restartable sequences aren't available operations must not be called, see Available.
+ */
+namespace Rseq {
+
+#ifdef AFINA_RSEQ
+
+// Signature kernel checks before abort handler, must be the same as registered by glibc
+#define AFINA_RSEQ_SIG "0x53053053"
+
+// Critical section descriptor and abort handler. Descriptor is stored into rseq_cs field (offset 8) of the
+// thread area to start section, cpu_id is at offset 4
+#define AFINA_RSEQ_BEGIN(abort_label)                                                                              \
+    ".pushsection __rseq_cs, \"aw\"\n\t"                                                                           \
+    ".balign 32\n\t"                                                                                               \
+    "3:\n\t"                                                                                                       \
+    ".long 0x0, 0x0\n\t"                                                                                           \
+    ".quad 1f, (2f - 1f), 4f\n\t"                                                                                  \
+    ".popsection\n\t"                                                                                              \
+    ".pushsection __rseq_failure, \"ax\"\n\t"                                                                      \
+    ".byte 0x0f, 0xb9, 0x3d\n\t"                                                                                   \
+    ".long " AFINA_RSEQ_SIG "\n\t"                                                                                 \
+    "4:\n\t"                                                                                                       \
+    "jmp %l[" abort_label "]\n\t"                                                                                  \
+    ".popsection\n\t"                                                                                              \
+    "leaq 3b(%%rip), %%rax\n\t"                                                                                    \
+    "movq %%rax, %%fs:8(%[rseq_offset])\n\t"                                                                       \
+    "1:\n\t"                                                                                                       \
+    "cmpl %[cpu], %%fs:4(%[rseq_offset])\n\t"                                                                      \
+    "jnz 4b\n\t"
+
+// Last instruction of the section must be followed by this one
+#define AFINA_RSEQ_COMMIT "2:\n\t"
+
+// Whether kernel and libc support restartable sequences for the current process
+inline bool Available() { return __rseq_size > 0; }
+
+// CPU the current thread runs on
+inline int CurrentCpu() {
+    if (!Available()) {
+        return sched_getcpu();
+    }
+    const struct rseq *area =
+        reinterpret_cast<const struct rseq *>(static_cast<char *>(__builtin_thread_pointer()) + __rseq_offset);
+    return static_cast<int>(__atomic_load_n(&area->cpu_id, __ATOMIC_RELAXED));
+}
+
+/**
+ * *v += count, if thread is still on the given cpu
+ */
+inline __attribute__((always_inline)) int AddV(intptr_t *v, intptr_t count, int cpu) {
+    __asm__ __volatile__ goto(AFINA_RSEQ_BEGIN("abort") "addq %[count], %[v]\n\t" AFINA_RSEQ_COMMIT
+                              : /* asm goto could not have outputs */
+                              : [cpu] "r"(cpu), [rseq_offset] "r"(__rseq_offset), [v] "m"(*v), [count] "er"(count)
+                              : "memory", "cc", "rax"
+                              : abort);
+    return 0;
+abort:
+    return -1;
+}
+
+/**
+ * if *v == expect then *v = newv, if thread is still on the given cpu. Returns 1 if *v != expect
+ */
+inline __attribute__((always_inline)) int CmpEqStoreV(intptr_t *v, intptr_t expect, intptr_t newv, int cpu) {
+    __asm__ __volatile__ goto(AFINA_RSEQ_BEGIN("abort") "cmpq %[v], %[expect]\n\t"
+                                                        "jnz %l[cmpfail]\n\t"
+                                                        "movq %[newv], %[v]\n\t" AFINA_RSEQ_COMMIT
+                              :
+                              : [cpu] "r"(cpu), [rseq_offset] "r"(__rseq_offset), [v] "m"(*v),
+                                [expect] "r"(expect), [newv] "r"(newv)
+                              : "memory", "cc", "rax"
+                              : abort, cmpfail);
+    return 0;
+abort:
+    return -1;
+cmpfail:
+    return 1;
+}
+
+/**
+ * if *v != expectnot then *load = *v and *v = *(*v + offset), if thread is still on the given cpu. Pops
+ * head of the intrusive list, where offset is the offset of the next pointer. Returns 1 if *v == expectnot
+ */
+inline __attribute__((always_inline)) int CmpNeStoreOffpLoad(intptr_t *v, intptr_t expectnot, long offset,
+                                                              intptr_t *load, int cpu) {
+    __asm__ __volatile__ goto(AFINA_RSEQ_BEGIN("abort") "movq %[v], %%rbx\n\t"
+                                                        "cmpq %%rbx, %[expectnot]\n\t"
+                                                        "je %l[cmpfail]\n\t"
+                                                        "movq %%rbx, %[load]\n\t"
+                                                        "addq %[offset], %%rbx\n\t"
+                                                        "movq (%%rbx), %%rbx\n\t"
+                                                        "movq %%rbx, %[v]\n\t" AFINA_RSEQ_COMMIT
+                              :
+                              : [cpu] "r"(cpu), [rseq_offset] "r"(__rseq_offset), [v] "m"(*v),
+                                [expectnot] "r"(expectnot), [offset] "er"(offset), [load] "m"(*load)
+                              : "memory", "cc", "rax", "rbx"
+                              : abort, cmpfail);
+    return 0;
+abort:
+    return -1;
+cmpfail:
+    return 1;
+}
+
+#undef AFINA_RSEQ_BEGIN
+#undef AFINA_RSEQ_COMMIT
+#undef AFINA_RSEQ_SIG
+
+#else // AFINA_RSEQ
+
+inline bool Available() { return false; }
+
+inline int CurrentCpu() { return sched_getcpu(); }
+
+inline int AddV(intptr_t *, intptr_t, int) { return -1; }
+inline int CmpEqStoreV(intptr_t *, intptr_t, intptr_t, int) { return -1; }
+inline int CmpNeStoreOffpLoad(intptr_t *, intptr_t, long, intptr_t *, int) { return -1; }
+
+#endif // AFINA_RSEQ
+
+// Upper bound of CPU ids
+inline std::size_t PossibleCpus() {
+    long result = sysconf(_SC_NPROCESSORS_CONF);
+    return result > 0 ? static_cast<std::size_t>(result) : 1;
+}
+
+} // namespace Rseq
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_RSEQ_H
@@ -0,0 +1,109 @@
+#ifndef AFINA_CONCURRENCY_SPSC_QUEUE_H
+#define AFINA_CONCURRENCY_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Bounded single producer single consumer queue
+ * Same contract as MPMCQueue (see MPMCQueue.h), but only one thread may push and only one thread may pop.
+ * There are no CAS at all: each side owns its index and only publishes it. Each side also caches the last
+ * seen index of the other one, so that shared cache line is read only when the cached value says queue
+ * is full or empty.
+ */
+template <typename T> class SPSCQueue {
+public:
+    explicit SPSCQueue(std::size_t capacity) : _tail(0), _head_cache(0), _head(0), _tail_cache(0) {
+        if (capacity < 2) {
+            throw std::runtime_error("Queue capacity must be at least 2");
+        }
+
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _values.reset(new T[size]);
+    }
+
+    bool TryPush(T &&value) { return TryPushBatch(&value, 1) == 1; }
+
+    bool TryPush(const T &value) {
+        T copy(value);
+        return TryPush(std::move(copy));
+    }
+
+    bool TryPop(T &value) { return TryPopBatch(&value, 1) == 1; }
+
+    /**
+     * Moves up to count elements from the given array into the queue, returns how many of them were added
+     */
+    std::size_t TryPushBatch(T *values, std::size_t count) {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        std::size_t free = Capacity() - (tail - _head_cache);
+        if (free < count) {
+            _head_cache = _head.load(std::memory_order_acquire);
+            free = Capacity() - (tail - _head_cache);
+        }
+
+        count = std::min(count, free);
+        for (std::size_t i = 0; i < count; i++) {
+            _values[(tail + i) & _mask] = std::move(values[i]);
+        }
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Takes up to count oldest elements into the given array, returns how many of them were taken
+     */
+    std::size_t TryPopBatch(T *values, std::size_t count) {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        std::size_t used = _tail_cache - head;
+        if (used < count) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            used = _tail_cache - head;
+        }
+
+        count = std::min(count, used);
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = std::move(_values[(head + i) & _mask]);
+        }
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate number of elements
+    std::size_t Size() const {
+        return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed);
+    }
+
+    inline std::size_t Capacity() const { return _mask + 1; }
+
+private:
+    SPSCQueue(const SPSCQueue &) = delete;
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    std::size_t _mask;
+    std::unique_ptr<T[]> _values;
+
+    // Producer side: own index and the last seen consumer index
+    alignas(64) std::atomic<std::size_t> _tail;
+    std::size_t _head_cache;
+
+    // Consumer side: own index and the last seen producer index
+    alignas(64) std::atomic<std::size_t> _head;
+    std::size_t _tail_cache;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SPSC_QUEUE_H
@@ -0,0 +1,52 @@
+#ifndef AFINA_CONCURRENCY_SHARDED_COUNTER_H
+#define AFINA_CONCURRENCY_SHARDED_COUNTER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Counter sharded by threads
+ * Each thread increments its own cell, so frequent updates from many threads never contend on the same
+ * cache line. Cells are summed only when counter is read, value of exited threads is kept aside.
+ */
+class ShardedCounter {
+public:
+    ShardedCounter() : _retired(0), _cells([this](Cell &cell) { _retired += cell.value.load(); }) {}
+
+    void Add(uint64_t n = 1) {
+        // Cell is written by its own thread only, so there is no need for atomic increment
+        Cell &cell = _cells.Get();
+        cell.value.store(cell.value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t Read() {
+        uint64_t result = 0;
+        _cells.ForEach([&result](Cell &cell) { result += cell.value.load(std::memory_order_relaxed); },
+                       [&result, this] { result += _retired; });
+        return result;
+    }
+
+private:
+    // Not over-aligned, since C++11 allocator ignores that. Padding on both sides keeps any cache line
+    // holding the value inside of the cell wherever list node is placed
+    struct Cell {
+        char before[64 - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> value{0};
+        char after[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    // Sum of the cells of exited threads, guarded by the ThreadLocal lock
+    uint64_t _retired;
+
+    ThreadLocal<Cell> _cells;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARDED_COUNTER_H
@@ -1,10 +1,180 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+namespace detail {
+
+/**
+ * Per thread table of the values owned by all ThreadLocal instances. Values are released by the table
+ * destructor, i.e when thread exits
+ */
+struct ThreadLocalTable {
+    struct Entry {
+        // Unique id of the ThreadLocal, addresses could be reused
+        uint64_t id;
+        void *value;
+
+        // State of the ThreadLocal, kept alive while thread refers to it
+        std::shared_ptr<void> owner;
+
+        // Removes value from the owner, does nothing if owner is destroyed already
+        void (*release)(void *owner, void *value);
+
+        // Checks if owner is destroyed
+        bool (*dead)(void *owner);
+    };
+
+    ~ThreadLocalTable() {
+        for (auto &entry : entries) {
+            entry.release(entry.owner.get(), entry.value);
+        }
+    }
+
+    static ThreadLocalTable &Current() {
+        static thread_local ThreadLocalTable table;
+        return table;
+    }
+
+    static uint64_t NextId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<Entry> entries;
+};
+
+} // namespace detail
+
+/**
+ * # Per thread value
+ * Each thread accessing the object gets its own instance of T, created on the first access. Unlike plain
+ * thread_local variable it could be a class member, and owner could iterate over instances of all live
+ * threads. Instance is destroyed either when its thread exits or when ThreadLocal itself is destroyed,
+ * whichever comes first.
+ *
+ * Get is lock-free after the first call in the thread. ForEach and thread exit take a mutex, so other
+ * threads could read instances while their owners are running: T must make that safe by itself, e.g by
+ * keeping atomics.
+ */
+template <typename T> class ThreadLocal {
+public:
+    /**
+     * @param on_exit called for the instance of exiting thread right before it is destroyed, while no
+     * ForEach runs. Allows to keep data which must outlive threads, like counters
+     */
+    explicit ThreadLocal(std::function<void(T &)> on_exit = nullptr)
+        : _id(detail::ThreadLocalTable::NextId()), _state(std::make_shared<State>()) {
+        _state->on_exit = std::move(on_exit);
+    }
+
+    ~ThreadLocal() {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        _state->alive = false;
+        _state->values.clear();
+    }
+
+    /**
+     * Returns instance of the current thread
+     */
+    T &Get() {
+        auto &entries = detail::ThreadLocalTable::Current().entries;
+        for (auto &entry : entries) {
+            if (entry.id == _id) {
+                return *static_cast<T *>(entry.value);
+            }
+        }
+        return Create(entries);
+    }
+
+    /**
+     * Calls func for instance of each live thread
+     */
+    template <typename F> void ForEach(F func) {
+        ForEach(func, [] {});
+    }
+
+    /**
+     * Same as above, but calls done after all instances. Threads can't exit until done returns, so it
+     * could read data moved aside by on_exit without counting it twice
+     */
+    template <typename F, typename D> void ForEach(F func, D done) {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        for (auto &value : _state->values) {
+            func(value);
+        }
+        done();
+    }
+
+    // Number of live threads having an instance
+    std::size_t Size() {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        return _state->values.size();
+    }
+
+private:
+    ThreadLocal(const ThreadLocal &) = delete;
+    ThreadLocal &operator=(const ThreadLocal &) = delete;
+
+    // Shared with threads, so that it outlives ThreadLocal while some thread refers to it
+    struct State {
+        std::mutex mutex;
+        std::list<T> values;
+        std::function<void(T &)> on_exit;
+        bool alive = true;
+    };
+
+    static void Release(void *owner, void *value) {
+        State *state = static_cast<State *>(owner);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->alive) {
+            return;
+        }
+        for (auto it = state->values.begin(); it != state->values.end(); ++it) {
+            if (&*it == value) {
+                if (state->on_exit) {
+                    state->on_exit(*it);
+                }
+                state->values.erase(it);
+                return;
+            }
+        }
+    }
+
+    static bool Dead(void *owner) {
+        State *state = static_cast<State *>(owner);
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return !state->alive;
+    }
+
+    T &Create(std::vector<detail::ThreadLocalTable::Entry> &entries) {
+        // Good time to forget instances which were destroyed along with their ThreadLocal
+        for (auto it = entries.begin(); it != entries.end();) {
+            it = it->dead(it->owner.get()) ? entries.erase(it) : it + 1;
+        }
+
+        T *value;
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            _state->values.emplace_back();
+            value = &_state->values.back();
+        }
+        entries.push_back({_id, value, _state, Release, Dead});
+        return *value;
+    }
+
+    const uint64_t _id;
+    std::shared_ptr<State> _state;
+};
 
 } // namespace Concurrency
 } // namespace Afina
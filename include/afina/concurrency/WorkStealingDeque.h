@@ -0,0 +1,142 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+#define AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Chase-Lev work stealing deque
+ * Single owner pushes and pops elements on the bottom end, any other thread could steal them from the top
+ * end. All operations are lock-free, owner and thieves synchronize only when fighting for the last element.
+ *
+ * Buffer is a circular array which grows twice once it is full. Thief could still read from the old array,
+ * so replaced arrays are kept until the deque is destroyed: each one is half of the next, so that takes no
+ * more memory than the current array.
+ *
+ * Deque stores pointers, nullptr is reserved to report that there is nothing to take.
+ */
+template <typename T> class WorkStealingDeque {
+public:
+    WorkStealingDeque(std::size_t capacity = 256) : _top(0), _bottom(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _arrays.emplace_back(new Array(size));
+        _array.store(_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds element to the bottom, must be called by the owner only
+     */
+    void Push(T *value) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        Array *array = _array.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->mask)) {
+            array = Grow(array, top, bottom);
+        }
+
+        // Release publishes the element to the thieves reading bottom with acquire
+        array->Put(bottom, value);
+        _bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * Takes the most recently pushed element, must be called by the owner only. Returns nullptr if deque
+     * is empty
+     */
+    T *Pop() {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Array *array = _array.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Deque is empty
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *value = array->Get(bottom);
+        if (top == bottom) {
+            // The last element, thieves might want it as well
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                value = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    /**
+     * Takes the oldest element, could be called by any thread. Returns nullptr if deque is empty or
+     * another thread has won the race for the element
+     */
+    T *Steal() {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Array *array = _array.load(std::memory_order_acquire);
+        T *value = array->Get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return value;
+    }
+
+    // Approximate number of elements, exact only if called by the owner with no thieves around
+    std::size_t Size() const {
+        int64_t size = _bottom.load(std::memory_order_relaxed) - _top.load(std::memory_order_relaxed);
+        return size > 0 ? static_cast<std::size_t>(size) : 0;
+    }
+
+private:
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    struct Array {
+        explicit Array(std::size_t size) : mask(size - 1), slots(new std::atomic<T *>[size]) {}
+
+        T *Get(int64_t pos) const { return slots[pos & mask].load(std::memory_order_relaxed); }
+        void Put(int64_t pos, T *value) { slots[pos & mask].store(value, std::memory_order_relaxed); }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<T *>[]> slots;
+    };
+
+    // Owner only: replace array by the twice larger one holding the same elements
+    Array *Grow(Array *array, int64_t top, int64_t bottom) {
+        Array *bigger = new Array((array->mask + 1) * 2);
+        for (int64_t pos = top; pos < bottom; pos++) {
+            bigger->Put(pos, array->Get(pos));
+        }
+        _arrays.emplace_back(bigger);
+        _array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // Owner and thieves touch different ends, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    alignas(64) std::atomic<Array *> _array;
+
+    // All arrays ever used, the last one is current
+    std::vector<std::unique_ptr<Array>> _arrays;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_DEQUE_H
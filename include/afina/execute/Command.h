@@ -1,6 +1,7 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <cstddef>
 #include <string>
 
 namespace Afina {
@@ -18,6 +19,10 @@ public:
     Command() {}
     virtual ~Command() {}
 
+    // Command is built for every request, small ones are taken from the pool instead of the heap
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr, std::size_t size);
+
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
 };
 
@@ -2,6 +2,7 @@
 #define AFINA_EXECUTE_INSERT_COMMAND_H
 
 #include <cstdint>
+#include <ctime>
 #include <string>
 
 #include "Command.h"
@@ -22,6 +23,22 @@ public:
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
 
+    /**
+     * Converts memcached exptime into the unix time suitable for Storage: 0 means never, negative
+     * value means already expired, up to 30 days it is offset from now, otherwise it is unix time
+     */
+    std::time_t ExpireTime() const {
+        const int32_t max_relative = 60 * 60 * 24 * 30;
+        if (_expire == 0) {
+            return 0;
+        } else if (_expire < 0) {
+            return 1;
+        } else if (_expire <= max_relative) {
+            return std::time(nullptr) + _expire;
+        }
+        return _expire;
+    }
+
 protected:
     const std::string _key;
     const uint32_t _flags;
@@ -0,0 +1,102 @@
+#include <afina/allocator/Arena.h>
+
+#include <cstdint>
+#include <new>
+
+namespace Afina {
+namespace Allocator {
+
+static inline char *AlignUp(char *pos, std::size_t alignment) {
+    return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(pos) + alignment - 1) & ~(alignment - 1));
+}
+
+// Block header is followed by memory aligned as for any type
+const std::size_t Arena::kHeaderSize =
+    (sizeof(Arena::Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+// See Arena.h
+Arena::Arena(std::size_t block_size)
+    : _block_size(block_size), _blocks(nullptr), _dedicated(nullptr), _pos(nullptr), _end(nullptr), _last(nullptr),
+      _allocated(0), _footprint(0) {}
+
+// See Arena.h
+Arena::~Arena() {
+    FreeBlocks(_dedicated);
+    FreeBlocks(_blocks);
+}
+
+// See Arena.h
+void *Arena::Allocate(std::size_t size, std::size_t alignment) {
+    _allocated += size;
+
+    if (size > _block_size / 4) {
+        // Dedicated block goes to its own list, so that bump allocation continues as before
+        Block *block = NewBlock(size);
+        block->prev = _dedicated;
+        _dedicated = block;
+        return reinterpret_cast<char *>(block) + kHeaderSize;
+    }
+
+    char *result = AlignUp(_pos, alignment);
+    if (_pos == nullptr || result + size > _end) {
+        Block *block = NewBlock(_block_size);
+        block->prev = _blocks;
+        _blocks = block;
+        _pos = reinterpret_cast<char *>(block) + kHeaderSize;
+        _end = reinterpret_cast<char *>(block) + block->size;
+        result = AlignUp(_pos, alignment);
+    }
+
+    _pos = result + size;
+    _last = result;
+    return result;
+}
+
+// See Arena.h
+void Arena::Free(void *ptr, std::size_t size) {
+    if (ptr != nullptr && ptr == _last && _last + size == _pos) {
+        _pos = _last;
+        _last = nullptr;
+        _allocated -= size;
+    }
+}
+
+// See Arena.h
+void Arena::Reset() {
+    FreeBlocks(_dedicated);
+    _dedicated = nullptr;
+
+    // Blocks are linked from the newest to the oldest, the oldest one is kept
+    if (_blocks != nullptr) {
+        while (_blocks->prev != nullptr) {
+            Block *prev = _blocks->prev;
+            _footprint -= _blocks->size;
+            ::operator delete(_blocks);
+            _blocks = prev;
+        }
+        _pos = reinterpret_cast<char *>(_blocks) + kHeaderSize;
+        _end = reinterpret_cast<char *>(_blocks) + _blocks->size;
+    }
+    _last = nullptr;
+    _allocated = 0;
+}
+
+Arena::Block *Arena::NewBlock(std::size_t size) {
+    std::size_t total = kHeaderSize + size;
+    Block *block = static_cast<Block *>(::operator new(total));
+    block->size = total;
+    _footprint += total;
+    return block;
+}
+
+void Arena::FreeBlocks(Block *block) {
+    while (block != nullptr) {
+        Block *prev = block->prev;
+        _footprint -= block->size;
+        ::operator delete(block);
+        block = prev;
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
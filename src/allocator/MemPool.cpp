@@ -0,0 +1,174 @@
+#include <afina/allocator/MemPool.h>
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+namespace Afina {
+namespace Allocator {
+
+// Generation of the pool occupying each id, 0 if id is free
+static std::atomic<uint64_t> pool_generations[MemPool::kMaxPools];
+static std::atomic<uint64_t> next_generation(1);
+
+// Objects are aligned the same way as memory returned by operator new
+static const std::size_t kAlignment = alignof(std::max_align_t);
+
+static inline std::size_t AlignUp(std::size_t size) { return (size + kAlignment - 1) & ~(kAlignment - 1); }
+
+// See MemPool.h
+MemPool::MemPool(std::size_t object_size, SlabCache &cache)
+    : _cache(cache), _object_size(AlignUp(object_size == 0 ? 1 : object_size)), _all_magazines(nullptr),
+      _n_slabs(0) {
+    if (_object_size > _cache.SlabSize() - AlignUp(sizeof(Slab))) {
+        throw std::runtime_error("Object doesn't fit into slab");
+    }
+
+    _generation = next_generation.fetch_add(1, std::memory_order_relaxed);
+    for (_id = 0; _id < kMaxPools; _id++) {
+        uint64_t expected = 0;
+        if (pool_generations[_id].compare_exchange_strong(expected, _generation)) {
+            return;
+        }
+    }
+    throw std::runtime_error("Too many memory pools");
+}
+
+// See MemPool.h
+MemPool::~MemPool() {
+    pool_generations[_id].store(0, std::memory_order_release);
+
+    for (Slab *slab = _slabs.PopAll(); slab != nullptr;) {
+        Slab *next = slab->next;
+        _cache.Put(slab);
+        slab = next;
+    }
+
+    for (Magazine *magazine = _all_magazines.load(); magazine != nullptr;) {
+        Magazine *next = magazine->all_next;
+        delete magazine;
+        magazine = next;
+    }
+}
+
+// See MemPool.h
+void *MemPool::Alloc() {
+    ThreadMagazines &local = Local();
+    if (local.loaded != nullptr && local.loaded->count > 0) {
+        return local.loaded->objects[--local.loaded->count];
+    }
+    if (local.previous != nullptr && local.previous->count > 0) {
+        std::swap(local.loaded, local.previous);
+        return local.loaded->objects[--local.loaded->count];
+    }
+
+    // Both magazines are empty, exchange one for the full magazine
+    Magazine *full = _full.Pop();
+    if (full == nullptr) {
+        full = Refill();
+    }
+    if (local.loaded != nullptr) {
+        _empty.Push(local.loaded);
+    }
+    local.loaded = full;
+    return local.loaded->objects[--local.loaded->count];
+}
+
+// See MemPool.h
+void MemPool::Free(void *ptr) {
+    ThreadMagazines &local = Local();
+    if (local.loaded != nullptr && local.loaded->count < kMagazineSize) {
+        local.loaded->objects[local.loaded->count++] = ptr;
+        return;
+    }
+    if (local.previous != nullptr && local.previous->count < kMagazineSize) {
+        std::swap(local.loaded, local.previous);
+        local.loaded->objects[local.loaded->count++] = ptr;
+        return;
+    }
+
+    // Both magazines are full, one of them goes to depot
+    if (local.previous != nullptr) {
+        _full.Push(local.previous);
+    }
+    local.previous = local.loaded;
+    local.loaded = TakeEmpty();
+    local.loaded->objects[local.loaded->count++] = ptr;
+}
+
+// Magazines are released to the pools on thread exit, unless pool is gone already
+MemPool::ThreadCache::~ThreadCache() {
+    for (std::size_t id = 0; id < kMaxPools; id++) {
+        ThreadMagazines &local = pools[id];
+        if (local.pool != nullptr && pool_generations[id].load(std::memory_order_acquire) == local.generation) {
+            local.pool->Flush(local);
+        }
+    }
+}
+
+MemPool::ThreadMagazines &MemPool::Local() {
+    static thread_local ThreadCache cache;
+    ThreadMagazines &local = cache.pools[_id];
+    if (local.pool != this || local.generation != _generation) {
+        // Slot is left by the destroyed pool, its magazines are gone together with it
+        local.pool = this;
+        local.generation = _generation;
+        local.loaded = local.previous = nullptr;
+    }
+    return local;
+}
+
+MemPool::Magazine *MemPool::TakeEmpty() {
+    Magazine *magazine = _empty.Pop();
+    if (magazine != nullptr) {
+        return magazine;
+    }
+
+    magazine = new Magazine;
+    magazine->count = 0;
+    magazine->all_next = _all_magazines.load(std::memory_order_relaxed);
+    while (!_all_magazines.compare_exchange_weak(magazine->all_next, magazine, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+    }
+    return magazine;
+}
+
+MemPool::Magazine *MemPool::Refill() {
+    Slab *slab = static_cast<Slab *>(_cache.Get());
+    _slabs.Push(slab);
+    _n_slabs.fetch_add(1, std::memory_order_relaxed);
+
+    char *pos = reinterpret_cast<char *>(slab) + AlignUp(sizeof(Slab));
+    char *end = reinterpret_cast<char *>(slab) + _cache.SlabSize();
+
+    Magazine *result = nullptr;
+    while (pos + _object_size <= end) {
+        Magazine *magazine = TakeEmpty();
+        for (; magazine->count < kMagazineSize && pos + _object_size <= end; pos += _object_size) {
+            magazine->objects[magazine->count++] = pos;
+        }
+
+        if (result == nullptr) {
+            result = magazine;
+        } else {
+            _full.Push(magazine);
+        }
+    }
+    return result;
+}
+
+void MemPool::Flush(ThreadMagazines &local) {
+    for (Magazine *magazine : {local.loaded, local.previous}) {
+        if (magazine == nullptr) {
+            continue;
+        } else if (magazine->count == 0) {
+            _empty.Push(magazine);
+        } else {
+            _full.Push(magazine);
+        }
+    }
+    local.pool = nullptr;
+}
+
+} // namespace Allocator
+} // namespace Afina
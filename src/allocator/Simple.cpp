@@ -1,40 +1,421 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
 /**
- * TODO: semantics
- * @param N size_t
+ * Header of each block. Payload follows it, for free blocks payload keeps free list links
  */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
+struct Simple::Block {
+    // Payload size in bytes
+    size_t size;
 
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
+    // Payload size of the previous block, meaningless for the first one
+    size_t prev_size;
 
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
+    // Slot of the handle table pointing to this block, nullptr if block is free
+    void **handle;
 
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
+    // Neighbours in the free list
+    struct FreeLinks {
+        Block *prev;
+        Block *next;
+    };
 
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+    inline FreeLinks *Links() { return reinterpret_cast<FreeLinks *>(reinterpret_cast<char *>(this) + sizeof(Block)); }
+};
+
+static const size_t kAlignment = sizeof(void *);
+// Free block must hold free list links
+static const size_t kMinPayload = 2 * sizeof(void *);
+
+static inline size_t RoundUp(size_t size) {
+    size = (size + kAlignment - 1) & ~(kAlignment - 1);
+    return size < kMinPayload ? kMinPayload : size;
+}
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size), _last(nullptr), _free_blocks(nullptr) {
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(base) + kAlignment - 1) & ~(kAlignment - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(base) + size) & ~(kAlignment - 1);
+    if (end < begin) {
+        end = begin;
+    }
+
+    _begin = _top = reinterpret_cast<char *>(begin);
+    _handles = _end = reinterpret_cast<void **>(end);
+    _free_handles = nullptr;
+    _defrag_cursor = _begin;
+    _defrag_moved = 0;
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    void **handle = TakeHandle();
+    if (handle == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No space for handle");
+    }
+
+    Block *block = AllocBlock(RoundUp(N), handle);
+    if (block == nullptr) {
+        ReleaseHandle(handle);
+        throw AllocError(AllocErrorType::NoMemory, "No free block of requested size");
+    }
+
+    *handle = Payload(block);
+    return Pointer(handle);
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._handle == nullptr) {
+        p = alloc(N);
+        return;
+    }
+    if (!IsHandle(p._handle)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to allocator");
+    }
+
+    size_t size = RoundUp(N);
+    Block *block = FromPayload(*p._handle);
+    if (size <= block->size) {
+        Split(block, size);
+        return;
+    }
+
+    // Last block could grow into the gap before handle table
+    Block *next = Next(block);
+    if (next == nullptr) {
+        size_t extra = size - block->size;
+        if (static_cast<size_t>(reinterpret_cast<char *>(_handles) - _top) >= extra) {
+            block->size = size;
+            _top += extra;
+            KeepDefragCursor(block);
+            return;
+        }
+    } else if (next->handle == nullptr && block->size + sizeof(Block) + next->size >= size) {
+        UnlinkFree(next);
+        block->size += sizeof(Block) + next->size;
+        KeepDefragCursor(block);
+        if (_last == next) {
+            _last = block;
+        } else {
+            Next(block)->prev_size = block->size;
+        }
+        Split(block, size);
+        return;
+    }
+
+    Block *moved = AllocBlock(size, p._handle);
+    if (moved == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free block of requested size");
+    }
+    std::memcpy(Payload(moved), Payload(block), block->size);
+    *p._handle = Payload(moved);
+    Release(block);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._handle == nullptr) {
+        return;
+    }
+    if (!IsHandle(p._handle)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to allocator");
+    }
+
+    Release(FromPayload(*p._handle));
+    ReleaseHandle(p._handle);
+    p._handle = nullptr;
+}
+
+// See Simple.h
+void Simple::defrag() {
+    char *dst = _begin;
+    Block *prev = nullptr;
+    for (char *cur = _begin; cur < _top;) {
+        Block *block = reinterpret_cast<Block *>(cur);
+        size_t total = sizeof(Block) + block->size;
+        cur += total;
+        if (block->handle == nullptr) {
+            continue;
+        }
+
+        Block *moved = reinterpret_cast<Block *>(dst);
+        if (moved != block) {
+            std::memmove(moved, block, total);
+            *moved->handle = Payload(moved);
+            _defrag_moved += total;
+        }
+        moved->prev_size = prev == nullptr ? 0 : prev->size;
+        prev = moved;
+        dst += total;
+    }
+
+    _top = dst;
+    _last = prev;
+    _free_blocks = nullptr;
+    _defrag_cursor = _top;
+}
+
+// See Simple.h
+bool Simple::defrag(size_t max_bytes, std::chrono::microseconds max_time) {
+    auto deadline = std::chrono::steady_clock::now() + max_time;
+    size_t moved = 0;
+    while (_defrag_cursor < _top) {
+        Block *block = reinterpret_cast<Block *>(_defrag_cursor);
+        if (block->handle == nullptr) {
+            // At least one block is moved per call, otherwise block larger than max_bytes blocks progress
+            if (moved > 0 && (moved >= max_bytes || std::chrono::steady_clock::now() >= deadline)) {
+                return false;
+            }
+            block = SlideOver(block);
+            moved += sizeof(Block) + block->size;
+        }
+        _defrag_cursor = Payload(block) + block->size;
+    }
+    return true;
+}
+
+// See Simple.h
+double Simple::fragmentation() const {
+    size_t gap = reinterpret_cast<char *>(_handles) - _top;
+    size_t total = gap, largest = gap;
+    for (Block *block = _free_blocks; block != nullptr; block = block->Links()->next) {
+        total += block->size;
+        largest = std::max(largest, block->size);
+    }
+    return total == 0 ? 0.0 : 1.0 - double(largest) / total;
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::ostringstream out;
+    size_t used = 0, free = 0, n_used = 0, n_free = 0;
+    for (char *cur = _begin; cur < _top;) {
+        Block *block = reinterpret_cast<Block *>(cur);
+        out << (cur - _begin) << ": " << (block->handle == nullptr ? "free " : "used ") << block->size << "\n";
+        if (block->handle == nullptr) {
+            free += block->size;
+            n_free++;
+        } else {
+            used += block->size;
+            n_used++;
+        }
+        cur += sizeof(Block) + block->size;
+    }
+
+    out << "used: " << used << " bytes in " << n_used << " blocks, free: " << free << " bytes in " << n_free
+        << " blocks, gap: " << (reinterpret_cast<char *>(_handles) - _top) << " bytes, handles: " << (_end - _handles)
+        << "\n";
+    out << "fragmentation: " << fragmentation() << ", defrag: " << (_defrag_cursor - _begin) << " of "
+        << (_top - _begin) << " bytes compacted, " << _defrag_moved << " bytes moved\n";
+    return out.str();
+}
+
+char *Simple::Payload(Block *block) { return reinterpret_cast<char *>(block) + sizeof(Block); }
+
+Simple::Block *Simple::FromPayload(void *payload) {
+    return reinterpret_cast<Block *>(static_cast<char *>(payload) - sizeof(Block));
+}
+
+Simple::Block *Simple::Next(Block *block) const {
+    char *next = Payload(block) + block->size;
+    return next == _top ? nullptr : reinterpret_cast<Block *>(next);
+}
+
+Simple::Block *Simple::Prev(Block *block) const {
+    char *cur = reinterpret_cast<char *>(block);
+    return cur == _begin ? nullptr : reinterpret_cast<Block *>(cur - block->prev_size - sizeof(Block));
+}
+
+void **Simple::TakeHandle() {
+    if (_free_handles != nullptr) {
+        void **handle = _free_handles;
+        _free_handles = static_cast<void **>(*handle);
+        return handle;
+    }
+
+    if (reinterpret_cast<char *>(_handles) - _top < static_cast<ptrdiff_t>(sizeof(void *))) {
+        return nullptr;
+    }
+    return --_handles;
+}
+
+void Simple::ReleaseHandle(void **handle) {
+    *handle = _free_handles;
+    _free_handles = handle;
+}
+
+bool Simple::IsHandle(void **handle) const {
+    if (handle < _handles || handle >= _end) {
+        return false;
+    }
+
+    char *payload = static_cast<char *>(*handle);
+    if (payload < _begin + sizeof(Block) || payload >= _top) {
+        return false;
+    }
+    return FromPayload(payload)->handle == handle;
+}
+
+void Simple::LinkFree(Block *block) {
+    Block::FreeLinks *links = block->Links();
+    links->prev = nullptr;
+    links->next = _free_blocks;
+    if (_free_blocks != nullptr) {
+        _free_blocks->Links()->prev = block;
+    }
+    _free_blocks = block;
+}
+
+void Simple::UnlinkFree(Block *block) {
+    Block::FreeLinks *links = block->Links();
+    if (links->prev != nullptr) {
+        links->prev->Links()->next = links->next;
+    } else {
+        _free_blocks = links->next;
+    }
+    if (links->next != nullptr) {
+        links->next->Links()->prev = links->prev;
+    }
+}
+
+Simple::Block *Simple::TakeFree(size_t size) {
+    for (Block *block = _free_blocks; block != nullptr; block = block->Links()->next) {
+        if (block->size >= size) {
+            UnlinkFree(block);
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+Simple::Block *Simple::Carve(size_t size) {
+    if (static_cast<size_t>(reinterpret_cast<char *>(_handles) - _top) < sizeof(Block) + size) {
+        return nullptr;
+    }
+
+    Block *block = reinterpret_cast<Block *>(_top);
+    block->size = size;
+    block->prev_size = _last == nullptr ? 0 : _last->size;
+    block->handle = nullptr;
+
+    _top += sizeof(Block) + size;
+    _last = block;
+    return block;
+}
+
+void Simple::Split(Block *block, size_t size) {
+    if (block->size < size + sizeof(Block) + kMinPayload) {
+        return;
+    }
+
+    Block *tail = reinterpret_cast<Block *>(Payload(block) + size);
+    tail->size = block->size - size - sizeof(Block);
+    tail->prev_size = size;
+    tail->handle = nullptr;
+    block->size = size;
+
+    if (_last == block) {
+        _last = tail;
+    } else {
+        Next(tail)->prev_size = tail->size;
+    }
+    Release(tail);
+}
+
+void Simple::Release(Block *block) {
+    block->handle = nullptr;
+
+    Block *next = Next(block);
+    if (next != nullptr && next->handle == nullptr) {
+        UnlinkFree(next);
+        block->size += sizeof(Block) + next->size;
+        if (_last == next) {
+            _last = block;
+        }
+    }
+
+    Block *prev = Prev(block);
+    if (prev != nullptr && prev->handle == nullptr) {
+        UnlinkFree(prev);
+        prev->size += sizeof(Block) + block->size;
+        if (_last == block) {
+            _last = prev;
+        }
+        block = prev;
+    }
+
+    // Hole appeared in the compacted part, incremental defrag has to get back here
+    if (reinterpret_cast<char *>(block) < _defrag_cursor) {
+        _defrag_cursor = reinterpret_cast<char *>(block);
+    }
+
+    // Free space at the end goes back to the gap
+    if (_last == block) {
+        _last = Prev(block);
+        _top = reinterpret_cast<char *>(block);
+        return;
+    }
+
+    Next(block)->prev_size = block->size;
+    LinkFree(block);
+}
+
+void Simple::KeepDefragCursor(Block *grown) {
+    // Cursor pointed to the absorbed free block or to the old end of blocks, both are inside the payload now.
+    // Grown block is used and everything before it has been compacted already
+    if (_defrag_cursor > reinterpret_cast<char *>(grown)) {
+        _defrag_cursor = reinterpret_cast<char *>(grown);
+    }
+}
+
+Simple::Block *Simple::AllocBlock(size_t size, void **handle) {
+    Block *block = TakeFree(size);
+    if (block != nullptr) {
+        block->handle = handle;
+        Split(block, size);
+        return block;
+    }
+
+    block = Carve(size);
+    if (block != nullptr) {
+        block->handle = handle;
+    }
+    return block;
+}
+
+Simple::Block *Simple::SlideOver(Block *hole) {
+    // Used block always follows the free one: neighbour free blocks are merged, the last one isn't free
+    Block *block = Next(hole);
+    size_t hole_size = hole->size, prev_size = hole->prev_size;
+    size_t total = sizeof(Block) + block->size;
+    bool last = _last == block;
+    UnlinkFree(hole);
+
+    Block *moved = hole;
+    std::memmove(moved, block, total);
+    moved->prev_size = prev_size;
+    *moved->handle = Payload(moved);
+    _defrag_moved += total;
+
+    // Hole is now behind moved block, it is merged with the next free block or returned to the gap
+    Block *rest = reinterpret_cast<Block *>(Payload(moved) + moved->size);
+    rest->size = hole_size;
+    rest->prev_size = moved->size;
+    rest->handle = nullptr;
+    _last = last ? rest : _last;
+    Release(rest);
+    return moved;
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -0,0 +1,232 @@
+#include <afina/allocator/Slab.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+
+namespace Afina {
+namespace Allocator {
+
+// Chunks are aligned the same way as memory returned by operator new
+static const std::size_t kAlignment = alignof(std::max_align_t);
+static const std::size_t kMinChunk = 64;
+
+static inline std::size_t AlignUp(std::size_t size) { return (size + kAlignment - 1) & ~(kAlignment - 1); }
+
+// See Slab.h
+Slab::Slab(std::size_t page_size, double growth_factor, std::size_t max_spare_pages)
+    : _header_size(AlignUp(sizeof(Page))), _page_size(page_size), _max_spare_pages(max_spare_pages), _pages(0),
+      _large_bytes(0) {
+    if (page_size == 0 || (page_size & (page_size - 1)) != 0 || page_size < 4 * kMinChunk) {
+        throw std::runtime_error("Slab page size must be power of two");
+    }
+    if (growth_factor <= 1.0) {
+        throw std::runtime_error("Slab growth factor must be greater than one");
+    }
+
+    // Largest class still has four chunks per page, bigger blocks waste too much of the page
+    const std::size_t max_chunk = ((_page_size - _header_size) / 4) & ~(kAlignment - 1);
+    for (std::size_t size = kMinChunk; size <= max_chunk;) {
+        SizeClass cls;
+        cls.chunk_size = size;
+        cls.chunks_per_page = (_page_size - _header_size) / size;
+        cls.partial = nullptr;
+        cls.full = nullptr;
+        cls.pages = 0;
+        _classes.push_back(cls);
+
+        std::size_t next = AlignUp(static_cast<std::size_t>(size * growth_factor));
+        size = std::max(next, size + kAlignment);
+    }
+}
+
+// See Slab.h
+Slab::~Slab() {
+    for (auto &cls : _classes) {
+        for (Page *head : {cls.partial, cls.full}) {
+            while (head != nullptr) {
+                Page *next = head->next;
+                std::free(head);
+                head = next;
+            }
+        }
+    }
+    for (Page *page : _spare) {
+        std::free(page);
+    }
+}
+
+// See Slab.h
+void *Slab::Allocate(std::size_t size) {
+    if (size > _classes.back().chunk_size) {
+        _large_bytes += size;
+        return ::operator new(size);
+    }
+
+    std::size_t cls = ClassFor(size);
+    SizeClass &sc = _classes[cls];
+    Page *page = sc.partial;
+    if (page == nullptr) {
+        page = NewPage(cls);
+    }
+
+    void *result;
+    if (page->free_chunks != nullptr) {
+        result = page->free_chunks;
+        page->free_chunks = *reinterpret_cast<void **>(result);
+    } else {
+        result = page->unused;
+        page->unused += sc.chunk_size;
+    }
+
+    if (++page->used == sc.chunks_per_page) {
+        Unlink(sc.partial, page);
+        Link(sc.full, page);
+    }
+    return result;
+}
+
+// See Slab.h
+void Slab::Free(void *ptr, std::size_t size) {
+    if (size > _classes.back().chunk_size) {
+        _large_bytes -= size;
+        ::operator delete(ptr);
+        return;
+    }
+
+    // Pages are aligned by their size, so header is found from any chunk address
+    Page *page = reinterpret_cast<Page *>(reinterpret_cast<uintptr_t>(ptr) & ~(_page_size - 1));
+    SizeClass &sc = _classes[page->cls];
+
+    *reinterpret_cast<void **>(ptr) = page->free_chunks;
+    page->free_chunks = ptr;
+
+    if (page->used-- == sc.chunks_per_page) {
+        Unlink(sc.full, page);
+        Link(sc.partial, page);
+    }
+    if (page->used == 0) {
+        Unlink(sc.partial, page);
+        ReleasePage(page);
+    }
+}
+
+// See Slab.h
+std::size_t Slab::BlockSize(std::size_t size) const {
+    if (size > _classes.back().chunk_size) {
+        return size;
+    }
+    return _classes[ClassFor(size)].chunk_size;
+}
+
+// See Slab.h
+bool Slab::NeedsPage(std::size_t size) const {
+    if (size > _classes.back().chunk_size) {
+        return false;
+    }
+    return _classes[ClassFor(size)].partial == nullptr && _spare.empty();
+}
+
+// See Slab.h
+bool Slab::PickDonor(std::size_t size, std::vector<void *> &chunks) const {
+    std::size_t target = size > _classes.back().chunk_size ? _classes.size() : ClassFor(size);
+
+    // Least used page gives the page away at the lowest cost. Full pages are candidates as well: class
+    // that lost its workload could keep all of them full
+    const Page *donor = nullptr;
+    for (std::size_t cls = 0; cls < _classes.size(); cls++) {
+        if (cls == target) {
+            continue;
+        }
+        for (const Page *head : {_classes[cls].partial, _classes[cls].full}) {
+            for (const Page *page = head; page != nullptr; page = page->next) {
+                if (donor == nullptr || page->used < donor->used) {
+                    donor = page;
+                }
+            }
+        }
+    }
+    if (donor == nullptr) {
+        return false;
+    }
+
+    std::vector<const void *> free_chunks;
+    for (const void *chunk = donor->free_chunks; chunk != nullptr; chunk = *static_cast<void *const *>(chunk)) {
+        free_chunks.push_back(chunk);
+    }
+    std::sort(free_chunks.begin(), free_chunks.end());
+
+    std::size_t chunk_size = _classes[donor->cls].chunk_size;
+    for (char *chunk = const_cast<char *>(reinterpret_cast<const char *>(donor)) + _header_size; chunk < donor->unused;
+         chunk += chunk_size) {
+        if (!std::binary_search(free_chunks.begin(), free_chunks.end(), chunk)) {
+            chunks.push_back(chunk);
+        }
+    }
+    return true;
+}
+
+void Slab::Link(Page *&head, Page *page) {
+    page->prev = nullptr;
+    page->next = head;
+    if (head != nullptr) {
+        head->prev = page;
+    }
+    head = page;
+}
+
+void Slab::Unlink(Page *&head, Page *page) {
+    if (page->prev != nullptr) {
+        page->prev->next = page->next;
+    } else {
+        head = page->next;
+    }
+    if (page->next != nullptr) {
+        page->next->prev = page->prev;
+    }
+}
+
+std::size_t Slab::ClassFor(std::size_t size) const {
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), size,
+                               [](const SizeClass &cls, std::size_t size) { return cls.chunk_size < size; });
+    return it - _classes.begin();
+}
+
+Slab::Page *Slab::NewPage(std::size_t cls) {
+    Page *page;
+    if (!_spare.empty()) {
+        page = _spare.back();
+        _spare.pop_back();
+    } else {
+        void *memory = nullptr;
+        if (posix_memalign(&memory, _page_size, _page_size) != 0) {
+            throw std::bad_alloc();
+        }
+        page = static_cast<Page *>(memory);
+    }
+
+    page->free_chunks = nullptr;
+    page->unused = reinterpret_cast<char *>(page) + _header_size;
+    page->used = 0;
+    page->cls = cls;
+
+    Link(_classes[cls].partial, page);
+    _classes[cls].pages++;
+    _pages++;
+    return page;
+}
+
+void Slab::ReleasePage(Page *page) {
+    _classes[page->cls].pages--;
+    _pages--;
+    if (_spare.size() < _max_spare_pages) {
+        _spare.push_back(page);
+    } else {
+        std::free(page);
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
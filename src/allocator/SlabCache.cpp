@@ -0,0 +1,52 @@
+#include <afina/allocator/SlabCache.h>
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+namespace Afina {
+namespace Allocator {
+
+// See SlabCache.h
+SlabCache::SlabCache(std::size_t slab_size) : _slab_size(slab_size), _slabs(0) {
+    if (slab_size < sizeof(FreeSlab) || (slab_size & (slab_size - 1)) != 0) {
+        throw std::runtime_error("Slab size must be power of two");
+    }
+}
+
+// See SlabCache.h
+SlabCache::~SlabCache() {
+    FreeSlab *slab = _free.PopAll();
+    while (slab != nullptr) {
+        FreeSlab *next = slab->next;
+        std::free(slab);
+        slab = next;
+    }
+}
+
+// See SlabCache.h
+void *SlabCache::Get() {
+    FreeSlab *slab = _free.Pop();
+    if (slab != nullptr) {
+        return slab;
+    }
+
+    void *memory = nullptr;
+    if (posix_memalign(&memory, _slab_size, _slab_size) != 0) {
+        throw std::bad_alloc();
+    }
+    _slabs.fetch_add(1, std::memory_order_relaxed);
+    return memory;
+}
+
+// See SlabCache.h
+void SlabCache::Put(void *slab) { _free.Push(static_cast<FreeSlab *>(slab)); }
+
+// See SlabCache.h
+SlabCache &SlabCache::Default() {
+    static SlabCache cache;
+    return cache;
+}
+
+} // namespace Allocator
+} // namespace Afina
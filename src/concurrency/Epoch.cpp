@@ -0,0 +1,154 @@
+#include <afina/concurrency/Epoch.h>
+
+#include <algorithm>
+
+namespace Afina {
+namespace Concurrency {
+
+// See Epoch.h
+EpochDomain::EpochDomain()
+    : _epoch(0), _pending(0), _participants([this](Participant &participant) {
+          // Thread exits, its objects are freed by somebody else
+          std::lock_guard<std::mutex> orphans_lock(_orphans_mutex);
+          std::lock_guard<std::mutex> lock(participant.mutex);
+          _orphans.insert(_orphans.end(), participant.retired.begin(), participant.retired.end());
+          participant.retired.clear();
+      }),
+      _running(false) {}
+
+// See Epoch.h
+EpochDomain::~EpochDomain() {
+    Stop();
+
+    std::vector<Retired> objects;
+    _participants.ForEach([&objects](Participant &participant) {
+        std::lock_guard<std::mutex> lock(participant.mutex);
+        objects.insert(objects.end(), participant.retired.begin(), participant.retired.end());
+        participant.retired.clear();
+    });
+    {
+        std::lock_guard<std::mutex> lock(_orphans_mutex);
+        objects.insert(objects.end(), _orphans.begin(), _orphans.end());
+        _orphans.clear();
+    }
+    Free(objects);
+}
+
+// See Epoch.h
+EpochDomain::Guard EpochDomain::Pin() {
+    Participant &participant = _participants.Get();
+    if (participant.depth++ == 0) {
+        // Announcement must be visible before any shared pointer is read, so that writer either sees the
+        // thread pinned or reader sees the object unlinked
+        uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+        participant.state.exchange((epoch << 1) | 1, std::memory_order_seq_cst);
+    }
+    return Guard(this, &participant);
+}
+
+// See Epoch.h
+void EpochDomain::Unpin(Participant &participant) {
+    if (--participant.depth == 0) {
+        participant.state.store(0, std::memory_order_release);
+    }
+}
+
+// See Epoch.h
+void EpochDomain::Retire(void *object, Deleter deleter, void *context) {
+    Participant &participant = _participants.Get();
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(participant.mutex);
+        participant.retired.push_back({object, deleter, context, epoch});
+    }
+    _pending.fetch_add(1, std::memory_order_relaxed);
+}
+
+// See Epoch.h
+std::size_t EpochDomain::Collect() {
+    TryAdvance();
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+
+    std::vector<Retired> objects;
+    _participants.ForEach([epoch, &objects](Participant &participant) {
+        std::lock_guard<std::mutex> lock(participant.mutex);
+        TakeSafe(participant.retired, epoch, objects);
+    });
+    {
+        std::lock_guard<std::mutex> lock(_orphans_mutex);
+        TakeSafe(_orphans, epoch, objects);
+    }
+    return Free(objects);
+}
+
+// See Epoch.h
+void EpochDomain::TryAdvance() {
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    bool lagging = false;
+    _participants.ForEach([epoch, &lagging](Participant &participant) {
+        uint64_t state = participant.state.load(std::memory_order_seq_cst);
+        if ((state & 1) != 0 && (state >> 1) != epoch) {
+            lagging = true;
+        }
+    });
+
+    if (!lagging) {
+        _epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+}
+
+// See Epoch.h
+void EpochDomain::TakeSafe(std::vector<Retired> &retired, uint64_t epoch, std::vector<Retired> &out) {
+    // Lists of exited threads are merged into orphans, so order of epochs isn't kept there
+    auto it = std::stable_partition(retired.begin(), retired.end(),
+                                    [epoch](const Retired &object) { return object.epoch + 2 <= epoch; });
+    out.insert(out.end(), retired.begin(), it);
+    retired.erase(retired.begin(), it);
+}
+
+// See Epoch.h
+std::size_t EpochDomain::Free(std::vector<Retired> &objects) {
+    for (auto &retired : objects) {
+        retired.deleter(retired.object, retired.context);
+    }
+    _pending.fetch_sub(objects.size(), std::memory_order_relaxed);
+    return objects.size();
+}
+
+// See Epoch.h
+void EpochDomain::Start(std::chrono::milliseconds tick) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _thread = std::thread(&EpochDomain::OnRun, this, tick);
+}
+
+// See Epoch.h
+void EpochDomain::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+        _stop_condition.notify_all();
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See Epoch.h
+void EpochDomain::OnRun(std::chrono::milliseconds tick) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        lock.unlock();
+        Collect();
+        lock.lock();
+
+        _stop_condition.wait_for(lock, tick, [this] { return !_running; });
+    }
+}
+
+} // namespace Concurrency
+} // namespace Afina
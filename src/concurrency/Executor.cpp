@@ -1,5 +1,254 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include <afina/concurrency/WorkStealingDeque.h>
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+// How many times thread out of work looks for a task once again before it parks
+static const int kSpinRounds = 64;
+
+// Upper bound of tasks moved from the injection queue to the thread deque at once
+static const std::size_t kInjectBatch = 32;
+
+// Pool and deque of the current thread, used to submit tasks into own deque
+static thread_local Executor *current_executor = nullptr;
+static thread_local std::size_t current_index = 0;
+
+struct Executor::Worker {
+    WorkStealingDeque<std::function<void()>> deque;
+
+    // State of the xorshift generator used to pick victims
+    uint32_t seed;
+};
+
+static inline uint32_t NextRandom(uint32_t &seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void RunTask(const std::string &name, std::function<void()> &task) {
+    try {
+        task();
+    } catch (std::exception &ex) {
+        std::cerr << "Executor " << name << ": task failed: " << ex.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Executor " << name << ": task failed" << std::endl;
+    }
+}
+
+// See Executor.h
+Executor::Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark,
+                   std::size_t max_queue_size, std::chrono::milliseconds idle_time, Mode mode)
+    : name(name), low_watermark(low_watermark), high_watermark(high_watermark), max_queue_size(max_queue_size),
+      idle_time(idle_time), threads(0), idle_threads(0), state(State::kRun), mode(mode), injected_size(0),
+      pending(0), sleepers(0) {
+    if (high_watermark == 0 || low_watermark > high_watermark) {
+        throw std::runtime_error("Invalid executor watermarks");
+    }
+
+    std::size_t n_threads = low_watermark;
+    if (mode == Mode::kStealing) {
+        n_threads = high_watermark;
+        for (std::size_t i = 0; i < n_threads; i++) {
+            workers.emplace_back(new Worker());
+            workers.back()->seed = 2463534242u + i * 7919;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (std::size_t i = 0; i < n_threads; i++) {
+        StartThread();
+    }
+}
+
+// See Executor.h
+Executor::~Executor() { Stop(true); }
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state == State::kRun) {
+        state = threads == 0 ? State::kStopped : State::kStopping;
+        empty_condition.notify_all();
+    }
+
+    if (await) {
+        stop_condition.wait(lock, [this] { return state == State::kStopped; });
+    }
+}
+
+// See Executor.h
+std::size_t Executor::Threads() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return threads;
+}
+
+// See Executor.h
+std::size_t Executor::QueueSize() {
+    if (mode == Mode::kStealing) {
+        return pending.load();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+void Executor::StartThread() {
+    if (mode == Mode::kStealing) {
+        std::thread(perform_stealing, this, threads).detach();
+    } else {
+        std::thread(perform, this).detach();
+    }
+    threads++;
+}
+
+// Last thread of the stopping pool completes shutdown. Executor could be destroyed as soon as lock
+// is released, so it must not be touched after that
+void Executor::StopThread() {
+    if (--threads == 0 && state == State::kStopping) {
+        state = State::kStopped;
+        stop_condition.notify_all();
+    }
+}
+
+bool Executor::Submit(std::function<void()> task) {
+    // Task is counted before state check, so that stopping pool never sees itself empty while
+    // accepted task is on the way into the queue
+    if (pending.fetch_add(1) >= max_queue_size || state != State::kRun) {
+        pending.fetch_sub(1);
+        return false;
+    }
+
+    auto *ptr = new std::function<void()>(std::move(task));
+    if (current_executor == this) {
+        workers[current_index]->deque.Push(ptr);
+    } else {
+        std::unique_lock<std::mutex> lock(inject_mutex);
+        injected.push_back(ptr);
+        injected_size.store(injected.size(), std::memory_order_relaxed);
+    }
+
+    if (sleepers.load() > 0) {
+        Unpark();
+    }
+    return true;
+}
+
+void Executor::Unpark() {
+    // Sleeper registers itself and waits under the mutex, so once mutex is taken here it either
+    // waits already or will see pending task
+    { std::unique_lock<std::mutex> lock(mutex); }
+    empty_condition.notify_one();
+}
+
+std::function<void()> *Executor::TakeTask(std::size_t index) {
+    Worker &self = *workers[index];
+    std::function<void()> *task = self.deque.Pop();
+
+    if (task == nullptr && injected_size.load(std::memory_order_relaxed) > 0) {
+        // Fair share of injected tasks goes to the own deque, so that other threads could steal them
+        std::unique_lock<std::mutex> lock(inject_mutex);
+        std::size_t batch = std::min(kInjectBatch, injected.size() / workers.size() + 1);
+        for (std::size_t i = 0; i < batch && !injected.empty(); i++) {
+            if (task == nullptr) {
+                task = injected.front();
+            } else {
+                self.deque.Push(injected.front());
+            }
+            injected.pop_front();
+        }
+        injected_size.store(injected.size(), std::memory_order_relaxed);
+    }
+
+    if (task == nullptr) {
+        // Start from the random victim, so that thieves don't gang up on the same deque
+        const std::size_t n = workers.size();
+        const std::size_t start = NextRandom(self.seed) % n;
+        for (std::size_t i = 0; i < n && task == nullptr; i++) {
+            std::size_t victim = (start + i) % n;
+            if (victim != index) {
+                task = workers[victim]->deque.Steal();
+            }
+        }
+    }
+
+    if (task != nullptr) {
+        pending.fetch_sub(1);
+    }
+    return task;
+}
+
+// See Executor.h
+void perform(Executor *executor) {
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    for (;;) {
+        if (executor->tasks.empty()) {
+            if (executor->state != Executor::State::kRun) {
+                break;
+            }
+
+            executor->idle_threads++;
+            bool has_task = executor->empty_condition.wait_for(lock, executor->idle_time, [executor] {
+                return !executor->tasks.empty() || executor->state != Executor::State::kRun;
+            });
+            executor->idle_threads--;
+
+            // Nothing to do for a while, pool shrinks down to low watermark
+            if (!has_task && executor->threads > executor->low_watermark) {
+                break;
+            }
+            continue;
+        }
+
+        auto task = std::move(executor->tasks.front());
+        executor->tasks.pop_front();
+
+        lock.unlock();
+        RunTask(executor->name, task);
+        lock.lock();
+    }
+    executor->StopThread();
+}
+
+// See Executor.h
+void perform_stealing(Executor *executor, std::size_t index) {
+    current_executor = executor;
+    current_index = index;
+
+    for (;;) {
+        std::function<void()> *task = executor->TakeTask(index);
+        for (int spin = 0; task == nullptr && spin < kSpinRounds; spin++) {
+            // Task might be on the way, it is cheaper to wait a bit than to park and get woken up
+            std::this_thread::yield();
+            task = executor->TakeTask(index);
+        }
+
+        if (task != nullptr) {
+            RunTask(executor->name, *task);
+            delete task;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(executor->mutex);
+        if (executor->pending.load() == 0 && executor->state != Executor::State::kRun) {
+            current_executor = nullptr;
+            executor->StopThread();
+            return;
+        }
+
+        executor->sleepers++;
+        executor->empty_condition.wait(lock, [executor] {
+            return executor->pending.load() > 0 || executor->state != Executor::State::kRun;
+        });
+        executor->sleepers--;
+    }
+}
+
+} // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,104 @@
+#include <afina/concurrency/ProfiledMutex.h>
+
+#include <map>
+#include <memory>
+
+namespace Afina {
+namespace Concurrency {
+
+// Profiles of all locks, never destroyed so that locks of detached threads could be used during exit
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<LockProfile>> profiles;
+};
+
+static Registry &GetRegistry() {
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+// See ProfiledMutex.h
+uint64_t LockProfile::Snapshot::Percentile(const uint64_t *hist, double fraction) {
+    uint64_t total = 0;
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        seen += hist[i];
+        if (seen >= fraction * total) {
+            return uint64_t(1) << (i + 1);
+        }
+    }
+    return uint64_t(1) << kBuckets;
+}
+
+// See ProfiledMutex.h
+LockProfile::LockProfile(const std::string &name)
+    : _name(name), _shards([this](Shard &shard) { Merge(_retired, shard); }) {}
+
+// See ProfiledMutex.h
+LockProfile &LockProfile::Get(const std::string &name) {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto &profile = registry.profiles[name];
+    if (!profile) {
+        profile.reset(new LockProfile(name));
+    }
+    return *profile;
+}
+
+// See ProfiledMutex.h
+std::vector<LockProfile::Snapshot> LockProfile::ReadAll() {
+    std::vector<LockProfile *> profiles;
+    {
+        Registry &registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto &it : registry.profiles) {
+            profiles.push_back(it.second.get());
+        }
+    }
+
+    std::vector<Snapshot> result;
+    for (auto profile : profiles) {
+        result.push_back(profile->Read());
+    }
+    return result;
+}
+
+// See ProfiledMutex.h
+LockProfile::Snapshot LockProfile::Read() {
+    Snapshot result;
+    _shards.ForEach([&result](Shard &shard) { Merge(result, shard); },
+                    [&result, this] {
+                        result.acquisitions += _retired.acquisitions;
+                        result.contended += _retired.contended;
+                        result.wait_ns += _retired.wait_ns;
+                        result.hold_ns += _retired.hold_ns;
+                        for (std::size_t i = 0; i < kBuckets; i++) {
+                            result.wait_hist[i] += _retired.wait_hist[i];
+                            result.hold_hist[i] += _retired.hold_hist[i];
+                        }
+                    });
+    result.name = _name;
+    return result;
+}
+
+// See ProfiledMutex.h
+void LockProfile::Merge(Snapshot &snapshot, const Shard &shard) {
+    snapshot.acquisitions += shard.acquisitions.load(std::memory_order_relaxed);
+    snapshot.contended += shard.contended.load(std::memory_order_relaxed);
+    snapshot.wait_ns += shard.wait_ns.load(std::memory_order_relaxed);
+    snapshot.hold_ns += shard.hold_ns.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kBuckets; i++) {
+        snapshot.wait_hist[i] += shard.wait_hist[i].load(std::memory_order_relaxed);
+        snapshot.hold_hist[i] += shard.hold_hist[i].load(std::memory_order_relaxed);
+    }
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -15,7 +15,8 @@ void Append::Execute(Storage &storage, const std::string &args, std::string &out
         return;
     }
     value = value.substr(0, value.size() - 2);
-    storage.Put(_key, value + args);
+    // Like memcached, append ignores exptime of the command and keeps deadline of the item
+    storage.Put(_key, value + args, Storage::kKeepExpire);
     out.assign("STORED");
 }
 
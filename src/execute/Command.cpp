@@ -1 +1,31 @@
 #include <afina/execute/Command.h>
+
+#include <afina/allocator/MemPool.h>
+
+namespace Afina {
+namespace Execute {
+
+// All commands fit into this size, bigger ones go to the heap
+static const std::size_t kPooledCommandSize = 128;
+
+static Allocator::MemPool &CommandPool() {
+    static Allocator::MemPool pool(kPooledCommandSize);
+    return pool;
+}
+
+// See Command.h
+void *Command::operator new(std::size_t size) {
+    return size <= kPooledCommandSize ? CommandPool().Alloc() : ::operator new(size);
+}
+
+// See Command.h
+void Command::operator delete(void *ptr, std::size_t size) {
+    if (size <= kPooledCommandSize) {
+        CommandPool().Free(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,3 +1,4 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
 
@@ -28,10 +29,14 @@ void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
 
     std::stringstream outStream;
 
+    Counters &counters = Counters::Global();
     std::string value;
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+        if (!storage.Get(key, value)) {
+            counters.get_misses.Add();
             continue;
+        }
+        counters.get_hits.Add();
         value = value.substr(0, value.size() - 2);    
         outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
         outStream << value << "\r\n";
@@ -13,7 +13,7 @@ void Replace::Execute(Storage &storage, const std::string &args, std::string &ou
     std::cout << "Replace(" << _key << "): " << args << std::endl;
     std::string value;
     if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
+        storage.Set(_key, args, ExpireTime());
         out = "STORED";
     } else {
         out = "NOT_STORED";
@@ -1,4 +1,6 @@
+#include <afina/Counters.h>
 #include <afina/Storage.h>
+#include <afina/concurrency/ProfiledMutex.h>
 #include <afina/execute/Stats.h>
 
 #include <iostream>
@@ -8,7 +10,63 @@
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+/* memcached protocol:
+
+Each statistic is sent as
+
+STAT <name> <value>\r\n
+
+and the whole response is ended by "END\r\n"
+
+*/
+
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Counters &counters = Counters::Global();
+    std::pair<const char *, Concurrency::ShardedCounter *> stats[] = {
+        {"cmd_total", &counters.requests},        {"get_hits", &counters.get_hits},
+        {"get_misses", &counters.get_misses},     {"bytes_read", &counters.bytes_read},
+        {"bytes_written", &counters.bytes_written}, {"evictions", &counters.evictions},
+    };
+
+    std::stringstream outStream;
+    for (auto &stat : stats) {
+        outStream << "STAT " << stat.first << " " << stat.second->Read() << "\r\n";
+    }
+
+    // Locks profiled since the start, see ProfiledMutex.h. Histogram is the list of bucket counters, bucket i
+    // counts durations in [2^i, 2^(i+1)) nanoseconds
+    for (auto &lock : Concurrency::LockProfile::ReadAll()) {
+        if (lock.acquisitions == 0) {
+            continue;
+        }
+
+        std::string prefix = "STAT lock:" + lock.name + ":";
+        outStream << prefix << "acquisitions " << lock.acquisitions << "\r\n";
+        outStream << prefix << "contended " << lock.contended << "\r\n";
+        outStream << prefix << "wait_ns " << lock.wait_ns << "\r\n";
+        outStream << prefix << "hold_ns " << lock.hold_ns << "\r\n";
+
+        std::pair<const char *, uint64_t *> hists[] = {{"wait", lock.wait_hist}, {"hold", lock.hold_hist}};
+        for (auto &hist : hists) {
+            using Snapshot = Concurrency::LockProfile::Snapshot;
+            outStream << prefix << hist.first << "_p50_ns " << Snapshot::Percentile(hist.second, 0.5) << "\r\n";
+            outStream << prefix << hist.first << "_p99_ns " << Snapshot::Percentile(hist.second, 0.99) << "\r\n";
+
+            std::size_t used = Concurrency::LockProfile::kBuckets;
+            while (used > 1 && hist.second[used - 1] == 0) {
+                used--;
+            }
+            outStream << prefix << hist.first << "_hist ";
+            for (std::size_t i = 0; i < used; i++) {
+                outStream << (i > 0 ? "," : "") << hist.second[i];
+            }
+            outStream << "\r\n";
+        }
+    }
+    outStream << "END"; // networking layer should add the last \r\n
+
+    out = outStream.str();
+}
 
 } // namespace Execute
 } // namespace Afina
@@ -1,6 +1,7 @@
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <string>
 
 #include <atomic>
 #include <semaphore.h>
@@ -11,6 +12,7 @@
 
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/concurrency/ProfiledMutex.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
@@ -19,8 +21,15 @@
 #include "network/mt_nonblocking/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
+#ifdef AFINA_HAVE_IO_URING
+#include "network/uring/ServerImpl.h"
+#endif
 
+#include "storage/FlatCombineLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SimpleClock.h"
 #include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeClock.h"
 #include "storage/ThreadSafeSimpleLRU.h"
 
 #include "network/coroutine/ServerImpl.h"
@@ -46,16 +55,39 @@ public:
         logger.format = "[%H:%M:%S %z] [thread %t] [%n] [%l] %v";
         logService.reset(new Logging::ServiceImpl(logConfig));
 
+        // Lock profile is off by default, as it reads clock twice per critical section
+        Afina::Concurrency::LockProfile::Enable(options.count("lock-profile") > 0);
+
         // Step 1: configure storage
         std::string storage_type = "st_lru";
         if (options.count("storage") > 0) {
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Total number of bytes cache could store
+        std::size_t storage_size = 1024;
+        if (options.count("storage-size") > 0) {
+            storage_size = options["storage-size"].as<uint64_t>();
+        }
+
+        // Number of independent parts for the sharded storage
+        std::size_t storage_shards = 4;
+        if (options.count("storage-shards") > 0) {
+            storage_shards = options["storage-shards"].as<uint32_t>();
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(storage_size);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(storage_size);
+        } else if (storage_type == "sharded_lru") {
+            storage = std::make_shared<Afina::Backend::ShardedLRU>(storage_shards, storage_size);
+        } else if (storage_type == "st_clock") {
+            storage = std::make_shared<Afina::Backend::SimpleClock>(storage_size);
+        } else if (storage_type == "mt_clock") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeClock>(storage_size);
+        } else if (storage_type == "fc_lru") {
+            storage = std::make_shared<Afina::Backend::FlatCombineLRU>(storage_size);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -74,6 +106,24 @@ public:
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
             server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_reuseport") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::kReusePort);
+        } else if (network_type == "mt_handoff") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::kHandOff);
+        } else if (network_type == "uring") {
+#ifdef AFINA_HAVE_IO_URING
+            if (Afina::Network::Uring::ServerImpl::Supported()) {
+                server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
+            }
+#endif
+            // Kernel or its headers are too old, readiness based server is the closest one. Logging isn't
+            // started yet, so the warning is written by Start
+            if (!server) {
+                network_fallback = "io_uring is not available, fallback to mt_nonblock";
+                server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            }
         } else if (network_type == "coroutine") {
             server = std::make_shared<Afina::Network::Coroutine::ServerImpl>(storage, logService);        
         } else {
@@ -90,6 +140,10 @@ public:
         log->warn("Start storage");
         storage->Start();
 
+        if (!network_fallback.empty()) {
+            log->warn(network_fallback);
+        }
+
         // TODO: configure network service
         const uint16_t port = 8080;
         log->warn("Start network on {}", port);
@@ -113,6 +167,9 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Afina::Network::Server> server;
+
+    // Why requested network implementation was replaced, empty if it wasn't
+    std::string network_fallback;
 };
 
 // Signal set that to notify application about time to stop
@@ -132,7 +189,11 @@ int main(int argc, char **argv) {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("storage-size", "Max number of bytes storage could hold", cxxopts::value<uint64_t>());
+        options.add_options()("storage-shards", "Number of shards for sharded_lru storage",
+                              cxxopts::value<uint32_t>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("lock-profile", "Collect lock contention profile, shown by stats command");
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
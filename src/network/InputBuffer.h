@@ -0,0 +1,88 @@
+#ifndef AFINA_NETWORK_INPUT_BUFFER_H
+#define AFINA_NETWORK_INPUT_BUFFER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Input buffer of the connection
+ * Ring of bytes between the socket and the parser. Parsed bytes are released by moving the read cursor,
+ * so nothing is moved in memory after each command however deep the pipeline is. Data from the socket
+ * lands into all free space by one readv, even if it wraps around the end of the buffer.
+ *
+ * Parser walks the data chunk by chunk: Data/Chunk give the contiguous part from the read cursor, once it
+ * is consumed the rest starts from the beginning of the storage.
+ */
+template <std::size_t Capacity = 4096> class InputBuffer {
+public:
+    InputBuffer() : _head(0), _size(0) {}
+
+    // Bytes waiting for the parser
+    inline std::size_t Size() const { return _size; }
+    inline bool Empty() const { return _size == 0; }
+    inline bool Full() const { return _size == Capacity; }
+
+    // Contiguous part of the data starting from the read cursor
+    inline const char *Data() const { return _data + _head; }
+    inline std::size_t Chunk() const { return std::min(_size, Capacity - _head); }
+
+    // Releases n bytes of the current chunk
+    void Consume(std::size_t n) {
+        assert(n <= Chunk());
+        _size -= n;
+
+        // Empty buffer starts over, so that the next read goes into single contiguous region
+        _head = _size == 0 ? 0 : (_head + n) % Capacity;
+    }
+
+    void Clear() {
+        _head = 0;
+        _size = 0;
+    }
+
+    /**
+     * Reads from the descriptor into all free space of the buffer. Returns result of readv, so 0 means
+     * end of stream. If buffer is full returns -1 with ENOBUFS
+     */
+    ssize_t ReadFrom(int fd) {
+        if (Full()) {
+            errno = ENOBUFS;
+            return -1;
+        }
+
+        struct iovec iov[2];
+        std::size_t tail = (_head + _size) % Capacity;
+        std::size_t free = Capacity - _size;
+
+        iov[0].iov_base = _data + tail;
+        iov[0].iov_len = std::min(free, Capacity - tail);
+        iov[1].iov_base = _data;
+        iov[1].iov_len = free - iov[0].iov_len;
+
+        ssize_t result = readv(fd, iov, iov[1].iov_len > 0 ? 2 : 1);
+        if (result > 0) {
+            _size += result;
+        }
+        return result;
+    }
+
+private:
+    char _data[Capacity];
+
+    // Read cursor and number of bytes after it, write cursor follows them
+    std::size_t _head;
+    std::size_t _size;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_INPUT_BUFFER_H
@@ -1,5 +1,7 @@
 #include "ServerImpl.h"
 
+#include <afina/Counters.h>
+
 namespace Afina {
 namespace Network {
 namespace Coroutine {
@@ -67,7 +69,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     {
-        std::lock_guard<std::mutex> lock(_m);
+        std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
         conns = nullptr;
     }
 
@@ -89,7 +91,7 @@ void ServerImpl::Stop() {
     _running = false;
 
     {
-        std::lock_guard<std::mutex> lock(_m);
+        std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
         for (auto connptr = conns; connptr != nullptr; connptr = connptr->next) {
             connptr->running = false;
         }
@@ -121,7 +123,7 @@ void ServerImpl::OnRun() {
     newconn->running = true;
     newconn->ctx = cur_rout;
     {
-        std::lock_guard<std::mutex> lock(_m);
+        std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
         conns = newconn;
     }
     while (_running) {
@@ -134,7 +136,7 @@ void ServerImpl::OnRun() {
         }
 
         {
-            std::lock_guard<std::mutex> lock(_m);
+            std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
             sockets.push_front(infd);
         }
 
@@ -161,7 +163,7 @@ void ServerImpl::Worker(int client_socket) {
     conn->running = true;
     conn->ctx = _engine.get_cur_routine();
     {
-        std::lock_guard<std::mutex> lock(_m);
+        std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
         conn->next = conns;
         conns = conn;
         if (conn->next != nullptr) {
@@ -169,21 +171,22 @@ void ServerImpl::Worker(int client_socket) {
         }
     }
     try {
-        int readed_bytes = -1;
-        char client_buffer[4096];
-        while (_running && (readed_bytes = _read(client_socket, client_buffer, sizeof(client_buffer), conn)) > 0) {
+        ssize_t readed_bytes = -1;
+        InputBuffer<> client_buffer;
+        while (_running && (readed_bytes = _read(client_socket, client_buffer, conn)) > 0) {
             _logger->debug("Got {} bytes from socket", readed_bytes);
+            Counters::Global().bytes_read.Add(readed_bytes);
 
             // Single block of data readed from the socket could trigger inside actions a multiple times,
             // for example:
             // - read#0: [<command1 start>]
             // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (readed_bytes > 0) {
-                _logger->debug("Process {} bytes", readed_bytes);
+            while (!client_buffer.Empty()) {
+                _logger->debug("Process {} bytes", client_buffer.Size());
                 // There is no command yet
                 if (!command_to_execute) {
                     std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                    if (parser.Parse(client_buffer.Data(), client_buffer.Chunk(), parsed)) {
                         // There is no command to be launched, continue to parse input stream
                         // Here we are, current chunk finished some command, process it
                         _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -198,21 +201,19 @@ void ServerImpl::Worker(int client_socket) {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
+                        client_buffer.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
+                    _logger->debug("Fill argument: {} bytes of {}", client_buffer.Size(), arg_remains);
                     // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+                    std::size_t to_read = std::min(arg_remains, client_buffer.Chunk());
+                    argument_for_command.append(client_buffer.Data(), to_read);
 
-                    std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+                    client_buffer.Consume(to_read);
                     arg_remains -= to_read;
-                    readed_bytes -= to_read;
                 }
                 // Thre is command & argument - RUN!
                 if (command_to_execute && arg_remains == 0) {
@@ -225,13 +226,14 @@ void ServerImpl::Worker(int client_socket) {
                     if (_write(client_socket, result.data(), result.size(), conn) == -1) {
                         break;
                     }
+                    Counters::Global().bytes_written.Add(result.size());
 
                     // Prepare for the next command
                     command_to_execute.reset();
                     argument_for_command.resize(0);
                     parser.Reset();
                 }
-            } // while (readed_bytes)
+            } // while (!client_buffer.Empty())
         }
         if (readed_bytes == 0) {
             _logger->debug("Connection closed");
@@ -243,7 +245,7 @@ void ServerImpl::Worker(int client_socket) {
     }
     del_conn_from_list(conn);
     {
-        std::lock_guard<std::mutex> lock(_m);
+        std::lock_guard<Concurrency::ProfiledMutex<>> lock(_m);
         sockets.remove(client_socket);
     }
     close(client_socket);
@@ -290,16 +292,16 @@ void ServerImpl::_block_on_epoll(int fd, uint32_t events, Connection *cur_conn)
     }
 }
 
-ssize_t ServerImpl::_read(int fd, void *buf, size_t count, Connection *conn) {
+ssize_t ServerImpl::_read(int fd, InputBuffer<> &buffer, Connection *conn) {
     while (conn->running) {
-        ssize_t bytes_read = read(fd, buf, count);
+        ssize_t bytes_read = buffer.ReadFrom(fd);
         if (bytes_read > 0) {
             return bytes_read;
         } else {
             _block_on_epoll(fd, EVENT_READ, conn);
             uint32_t events = conn->events;
             if ((events & EPOLLRDHUP) || (events & EPOLLERR) || (events & EPOLLHUP)) {
-                return read(fd, buf, count);
+                return buffer.ReadFrom(fd);
             }
         }
     }
@@ -336,7 +338,7 @@ int ServerImpl::_accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen, C
 }
 
 void ServerImpl::del_conn_from_list(Connection *cur_conn) {
-    std::lock_guard<std::mutex> lg(_m);
+    std::lock_guard<Concurrency::ProfiledMutex<>> lg(_m);
 
     if (cur_conn->prev != nullptr) {
         cur_conn->prev->next = cur_conn->next;
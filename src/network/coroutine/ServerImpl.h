@@ -22,11 +22,13 @@
 #include <thread>
 
 #include <afina/Storage.h>
+#include <afina/concurrency/ProfiledMutex.h>
 #include <afina/logging/Service.h>
 #include <spdlog/logger.h>
 
 #include "Connection.h"
 #include "Utils.h"
+#include "network/InputBuffer.h"
 #include <afina/coroutine/Engine.h>
 #include <afina/execute/Command.h>
 #include <afina/network/Server.h>
@@ -71,7 +73,7 @@ private:
     // Network thread
     std::thread _thread;
 
-    std::mutex _m;
+    Concurrency::ProfiledMutex<> _m{"coroutine.connections"};
     // List of connections
     Connection *conns;
 
@@ -89,7 +91,7 @@ private:
 
 private:
     // Coroutine-aware variants of standard functions
-    ssize_t _read(int fd, void *buf, size_t count, Connection *conn);
+    ssize_t _read(int fd, InputBuffer<> &buffer, Connection *conn);
     ssize_t _write(int fd, const void *buf, size_t count, Connection *conn);
     int _accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen, Connection *conn);
 
@@ -7,6 +7,7 @@
 #include <thread>
 #include <set>
 
+#include <afina/concurrency/ProfiledMutex.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -58,11 +59,12 @@ private:
     // Thread to run network on
     std::thread _thread;
 
-    std::condition_variable _server_stop;
+    // Waits on the profiled lock, so it can't be the plain std::condition_variable
+    std::condition_variable_any _server_stop;
 
     uint32_t _w_max;
     uint32_t _w_cur;
-    std::mutex _w_mutex;
+    Concurrency::ProfiledMutex<> _w_mutex{"mt_blocking.workers"};
     void Worker(int socket);
 };
 
@@ -19,7 +19,9 @@
 #include <sys/uio.h>
 
 #include <spdlog/logger.h>
+#include <afina/Counters.h>
 #include <afina/Storage.h>
+#include <afina/allocator/MemPool.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 #include "protocol/Parser.h"
@@ -28,21 +30,45 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+static Allocator::MemPool &ConnectionPool() {
+    static Allocator::MemPool pool(sizeof(Connection));
+    return pool;
+}
+
+// See Connection.h
+void *Connection::operator new(std::size_t size) {
+    assert(size == sizeof(Connection));
+    return ConnectionPool().Alloc();
+}
+
+// See Connection.h
+void Connection::operator delete(void *ptr) { ConnectionPool().Free(ptr); }
+
 static constexpr int EVENT_READ = EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLET | EPOLLONESHOT;
 static constexpr int EVENT_READ_WRITE = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLET | EPOLLONESHOT;        
 
+// While command is offloaded only hangup is watched
+static constexpr int EVENT_HOLD = EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLET | EPOLLONESHOT;
+
+// Edge triggered connection watches everything all the time, readiness is tracked by the connection itself
+static constexpr int EVENT_EDGE = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLERR | EPOLLHUP | EPOLLET;
+
+constexpr int Connection::kMaxReads;
+
 // See Connection.h
-void Connection::Start() {
+void Connection::Start(bool edge_triggered) {
     _logger->info("Start on descriptor {}", _socket);
-    std::lock_guard<std::mutex> lg{_mutex};
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
     _live = true;
+    _edge = edge_triggered;
     _event.data.ptr = this;
-    _event.events = EVENT_READ;
+    _event.events = _edge ? EVENT_EDGE : EVENT_READ;
 
-    readed_bytes = 0;
+    _read_buffer.Clear();
     _write_offset = 0;
     arg_remains = 0;
     command_to_execute = nullptr;
+    offload_command = false;
     parser = Protocol::Parser{};
     argument_for_command.clear();
     _write_buffers.clear();
@@ -51,7 +77,7 @@ void Connection::Start() {
 // See Connection.h
 void Connection::OnError() {
     _logger->info("OnError on descriptor {}", _socket);
-    std::lock_guard<std::mutex> lg{_mutex};
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
     _live = false;
     shutdown(_socket, SHUT_RDWR);
     _logger->error("Error connection on descriptor {}", _socket);
@@ -60,118 +86,232 @@ void Connection::OnError() {
 // See Connection.h
 void Connection::OnClose() {
     _logger->info("OnClose on descriptor {}", _socket);
-    std::lock_guard<std::mutex> lg{_mutex};
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
     _live = false;
     shutdown(_socket, SHUT_RDWR);
     _logger->debug("Closed connection on descriptor {}", _socket);
 }
 
 // See Connection.h
-void Connection::DoRead() {
+void Connection::SetInterest(int events) {
+    if (!_edge) {
+        _event.events = events;
+    }
+}
+
+// See Connection.h
+bool Connection::DoRead() {
     _logger->info("DoRead on descriptor {}", _socket);
-    std::lock_guard<std::mutex> lg{_mutex};
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
 
     try {
-        int readed_bytes_ = -1;
-
-        while ((readed_bytes_ = read(_socket, _read_buffer + readed_bytes, sizeof(_read_buffer) - readed_bytes)) > 0) {
-
-            _logger->debug("Got {} bytes from socket", readed_bytes_);
-
-            readed_bytes += readed_bytes_;
-
-            // Single block of data readed from the socket could trigger inside actions a multiple times,
-            // for example:
-            // - read#0: [<command1 start>]
-            // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (readed_bytes > 0) {
-                _logger->debug("Process {} bytes", readed_bytes);
-
-                // There is no command yet
-                if (!command_to_execute) {
-                    std::size_t parsed = 0;
-                    if (parser.Parse(_read_buffer, readed_bytes, parsed)) {
-                        // There is no command to be launched, continue to parse input stream
-                        // Here we are, current chunk finished some command, process it
-                        _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
-                        command_to_execute = parser.Build(arg_remains);
-                        if (arg_remains > 0) {
-                            arg_remains += 2;
-                        }
-                    }
-
-                    // Parsed might fails to consume any bytes from input stream. In real life that could happens,
-                    // for example, because we are working with UTF-16 chars and only 1 byte left in stream
-                    if (parsed == 0) {
-                        break;
-                    } else {
-                        std::memmove(_read_buffer, _read_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
-                    }
-                }
+        // Input could be left in the buffer while offloaded command was running
+        ProcessInput();
+
+        for (int reads = 0; !_offloaded && _readable; reads++) {
+            if (reads == kMaxReads) {
+                return true;
+            }
 
-                // There is command, but we still wait for argument to arrive...
-                if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(_read_buffer, to_read);
+            std::size_t space = kReadBufferSize - _read_buffer.Size();
+            ssize_t readed_bytes_ = _read_buffer.ReadFrom(_socket);
+            if (readed_bytes_ > 0) {
+                _logger->debug("Got {} bytes from socket", readed_bytes_);
+                Counters::Global().bytes_read.Add(readed_bytes_);
 
-                    std::memmove(_read_buffer, _read_buffer + to_read, readed_bytes - to_read);
-                    arg_remains -= to_read;
-                    readed_bytes -= to_read;
+                // Short read drains the socket, so there is no need for another read just to get EAGAIN:
+                // new data raises a new event
+                if (std::size_t(readed_bytes_) < space) {
+                    _readable = false;
                 }
+                ProcessInput();
+            } else if (readed_bytes_ == 0 || errno == EAGAIN || errno == EWOULDBLOCK) {
+                _logger->debug("Readed 0 bytes in DoRead");
+                _readable = false;
+            } else {
+                _readable = false;
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+    }
+    return false;
+}
 
-                // Thre is command & argument - RUN!
-                if (command_to_execute && arg_remains == 0) {
-                    _logger->debug("Start command execution");
-
-                    _logger->debug("arguments {}", argument_for_command);
-
-                    
-
-                    std::string result;
-                    try {
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
-                        result += "\r\n";
-                        _write_buffers.push_back(result);
-                        if (_write_buffers.size() == 1) {
-                            _event.events = EVENT_READ_WRITE;
-                        }
-                    } catch (std::runtime_error &ex) {
-                        _logger->error("Failed to Execute {}", ex.what());
-                        result = "SERVER_ERROR " + std::string(ex.what()) + "\r\n";
-                        if (send(_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response about server error");
-                        }
-                    }
-
-                    // Prepare for the next command
-                    command_to_execute.reset();
-                    argument_for_command.resize(0);
-                    parser.Reset();
+void Connection::ProcessInput() {
+    // Single block of data readed from the socket could trigger inside actions a multiple times,
+    // for example:
+    // - read#0: [<command1 start>]
+    // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
+    while (!_read_buffer.Empty() && !_offloaded) {
+        _logger->debug("Process {} bytes", _read_buffer.Size());
+
+        // There is no command yet
+        if (!command_to_execute) {
+            std::size_t parsed = 0;
+            if (parser.Parse(_read_buffer.Data(), _read_buffer.Chunk(), parsed)) {
+                // There is no command to be launched, continue to parse input stream
+                // Here we are, current chunk finished some command, process it
+                _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                command_to_execute = parser.Build(arg_remains);
+                offload_command = arg_remains >= kOffloadArgSize || parser.Keys().size() >= kOffloadKeys;
+                if (arg_remains > 0) {
+                    arg_remains += 2;
                 }
-            } // while (readed_bytes)
+            }
+
+            // Parsed might fails to consume any bytes from input stream. In real life that could happens,
+            // for example, because we are working with UTF-16 chars and only 1 byte left in stream
+            if (parsed == 0) {
+                break;
+            } else {
+                _read_buffer.Consume(parsed);
+            }
         }
 
-        if (readed_bytes == 0) {
-            _logger->debug("Readed 0 bytes in DoRead");
-        } else {
-            throw std::runtime_error(std::string(strerror(errno)));
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            _logger->debug("Fill argument: {} bytes of {}", _read_buffer.Size(), arg_remains);
+            // There is some parsed command, and now we are reading argument
+            std::size_t to_read = std::min(arg_remains, _read_buffer.Chunk());
+            argument_for_command.append(_read_buffer.Data(), to_read);
+
+            _read_buffer.Consume(to_read);
+            arg_remains -= to_read;
         }
 
+        // Thre is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            _logger->debug("Start command execution");
+            _logger->debug("arguments {}", argument_for_command);
+
+            // Expensive command goes to the executor, connection doesn't read anything until it is done
+            // to keep responses in order. Only hangup is watched meanwhile
+            if (offload_command && _executor->Execute(&Connection::RunOffloaded, this)) {
+                _logger->debug("Command offloaded to executor");
+                _offloaded = true;
+                SetInterest(_write_buffers.empty() ? EVENT_HOLD : (EVENT_HOLD | EPOLLOUT));
+                break;
+            }
+            ExecuteCommand();
+        }
+    } // while (!_read_buffer.Empty())
+}
+
+void Connection::ExecuteCommand() {
+    std::string result;
+    try {
+        command_to_execute->Execute(*pStorage, argument_for_command, result);
+        result += "\r\n";
     } catch (std::runtime_error &ex) {
-        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        _logger->error("Failed to Execute {}", ex.what());
+        result = "SERVER_ERROR " + std::string(ex.what()) + "\r\n";
+    }
+
+    _write_buffers.push_back(result);
+    if (_write_buffers.size() == 1) {
+        SetInterest(EVENT_READ_WRITE);
+    }
+
+    // Prepare for the next command
+    command_to_execute.reset();
+    argument_for_command.resize(0);
+    parser.Reset();
+}
+
+void Connection::RunOffloaded() {
+    // Worker doesn't touch command while it is offloaded, so it runs without connection lock
+    std::string result;
+    try {
+        command_to_execute->Execute(*pStorage, argument_for_command, result);
+        result += "\r\n";
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to Execute {}", ex.what());
+        result = "SERVER_ERROR " + std::string(ex.what()) + "\r\n";
+    }
+
+    std::unique_lock<Concurrency::Mutex> lock(_mutex);
+    _offloaded = false;
+    if (_detached) {
+        lock.unlock();
+        delete this;
+        return;
+    }
+
+    _write_buffers.push_back(result);
+    command_to_execute.reset();
+    argument_for_command.resize(0);
+    parser.Reset();
+
+    // Wakeup worker to send result and continue with the held input. Edge triggered connection is
+    // modified with the same events, that reports socket readiness once again. Worker serving the
+    // connection right now rearms it by itself
+    if (_live) {
+        SetInterest(EVENT_READ_WRITE);
+        _resume = true;
+        if (!_serving && epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, _socket, &_event)) {
+            _logger->error("Failed to rearm descriptor {} after offloaded command", _socket);
+        }
     }
 }
 
+// See Connection.h
+void Connection::Hold() {
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
+    _serving = true;
+}
+
+// See Connection.h
+bool Connection::Rearm() {
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
+    _serving = false;
+    if (!_live) {
+        return false;
+    }
+    if (_edge) {
+        return !_resume || epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, _socket, &_event) == 0;
+    }
+
+    // Offloaded command has completed, but worker haven't seen it yet: EPOLLOUT fires right away
+    if (_resume) {
+        _event.events |= EPOLLOUT;
+    }
+    _event.events |= EPOLLONESHOT;
+    return epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, _socket, &_event) == 0;
+}
+
+// See Connection.h
+bool Connection::Detach() {
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
+    _live = false;
+    _detached = true;
+    return !_offloaded;
+}
+
+// See Connection.h
+bool Connection::Migrate(int epoll_fd) {
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
+    if (!_live || _offloaded || _resume || _queued || !_read_buffer.Empty() || command_to_execute || !_write_buffers.empty()) {
+        return false;
+    }
+    _epoll_fd = epoll_fd;
+    return true;
+}
+
 // See Connection.h
 void Connection::DoWrite() {
     _logger->info("DoWrite on descriptor {}\n", _socket);
-    std::lock_guard<std::mutex> lg{_mutex};
+    std::lock_guard<Concurrency::Mutex> lg{_mutex};
 
     if (_write_buffers.empty()) { // nothing to write - better to check this way for safety
-        _event.events = EVENT_READ;
+        SetInterest(_offloaded ? EVENT_HOLD : EVENT_READ);
+        return;
+    }
+
+    // Socket buffer of edge triggered connection is full, EPOLLOUT tells once there is a room again.
+    // Level triggered one is written whenever worker calls, e.g. on EPOLLRDHUP without EPOLLOUT
+    if (_edge && !_writable) {
         return;
     }
 
@@ -195,11 +335,19 @@ void Connection::DoWrite() {
 
         written_bytes = writev(_socket, iov, cur_size);
 
-        // some error happened during writing
+        if (written_bytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            _writable = false;
+            break;
+        }
+
+        // some error happened during writing, lock is held already so that isn't OnError
         if (written_bytes == -1) {
-            OnError();
+            _live = false;
+            shutdown(_socket, SHUT_RDWR);
+            _logger->error("Failed to write to descriptor {}: {}", _socket, strerror(errno));
             return;
         }
+        Counters::Global().bytes_written.Add(written_bytes);
 
         auto it_delete_end = _write_buffers.begin();
         if (written_bytes > 0){
@@ -215,7 +363,7 @@ void Connection::DoWrite() {
     }
 
     if (_write_buffers.empty()) {
-        _event.events = EVENT_READ;
+        SetInterest(_offloaded ? EVENT_HOLD : EVENT_READ);
     }
 }
 
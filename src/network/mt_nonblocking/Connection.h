@@ -1,16 +1,21 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <list>
+#include <mutex>
 
 #include <sys/epoll.h>
 
 #include <spdlog/logger.h>
 
+#include "network/InputBuffer.h"
 #include "protocol/Parser.h"
 #include <afina/Storage.h>
+#include <afina/concurrency/AdaptiveMutex.h>
+#include <afina/concurrency/Executor.h>
 #include <afina/execute/Command.h>
 
 namespace Afina {
@@ -19,26 +24,75 @@ namespace MTnonblock {
 
 class Connection {
 public:
-    Connection(int s, std::shared_ptr<spdlog::logger> log, std::shared_ptr<Afina::Storage> ps)
-        : _socket(s), _logger(log), pStorage(ps) {
+    Connection(int s, std::shared_ptr<spdlog::logger> log, std::shared_ptr<Afina::Storage> ps,
+               Concurrency::Executor *executor, int epoll_fd)
+        : _socket(s), _logger(log), pStorage(ps), _executor(executor), _epoll_fd(epoll_fd), _offloaded(false),
+          _detached(false), _resume(false), _events(0), _edge(false), _readable(false), _writable(false),
+          _queued(false), _serving(false) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
     }
 
+    // Connections are created on every accept, so they come from the pool instead of the heap
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr);
+
     inline bool isAlive() {
-        std::lock_guard<std::mutex> lg{_mutex};
+        std::lock_guard<Concurrency::Mutex> lg{_mutex};
         return _live;
     }
 
-    void Start();
+    /**
+     * Prepares connection for registration in epoll. Edge triggered connection is registered once with
+     * all events of interest and never rearmed, that is only possible if single worker serves it
+     */
+    void Start(bool edge_triggered = false);
 
 protected:
     void OnError();
     void OnClose();
-    void DoRead();
+
+    // Returns true if input was left in the socket because of kMaxReads limit, so it must be called again
+    bool DoRead();
     void DoWrite();
 
+    // Worker starts serving connection, offloaded command completing meanwhile doesn't touch epoll
+    void Hold();
+
+    // Rearm connection in epoll with current interest, false if connection isn't alive anymore. Edge
+    // triggered connection is only rearmed to report readiness again for completed offloaded command
+    bool Rearm();
+
+    // Worker is done with connection, returns true if it could be deleted right away. Otherwise it is
+    // deleted by the offloaded command once that one completes
+    bool Detach();
+
+    // Switches connection to another epoll instance if it is between commands: nothing is buffered or
+    // offloaded, so the next event could be served by any thread. Returns false if connection is busy
+    bool Migrate(int epoll_fd);
+
 private:
+    // Commands with argument of at least that size or with that many keys are executed on the executor
+    static constexpr std::size_t kOffloadArgSize = 64 * 1024;
+    static constexpr std::size_t kOffloadKeys = 16;
+
+    static constexpr std::size_t kReadBufferSize = 4096;
+
+    // Reads from the socket in one DoRead, so that single busy connection doesn't starve the others
+    static constexpr int kMaxReads = 16;
+
+    // Sets events of interest used by the next rearm, no-op for edge triggered connection
+    void SetInterest(int events);
+
+    // Parse and execute commands from the read buffer until it is exhausted or command is offloaded
+    void ProcessInput();
+
+    // Execute command_to_execute and queue its result, mutex must be held
+    void ExecuteCommand();
+
+    // Body of the task running command on the executor
+    void RunOffloaded();
+
     friend class Worker;
     friend class ServerImpl;
 
@@ -49,17 +103,48 @@ private:
     std::shared_ptr<Afina::Storage> pStorage;
 
     bool _live;
-    std::mutex _mutex;
+    Concurrency::Mutex _mutex;
 
     std::list<std::string> _write_buffers;
     std::size_t _write_offset;
-    char _read_buffer[4096];
-    int readed_bytes;
+    InputBuffer<kReadBufferSize> _read_buffer;
 
     std::size_t arg_remains;
     Protocol::Parser parser;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
+    bool offload_command;
+
+    // Pool running expensive commands, so that worker keeps serving other connections
+    Concurrency::Executor *_executor;
+    int _epoll_fd;
+
+    // Command is running on the executor, input is held until it completes
+    bool _offloaded;
+
+    // Worker has dropped connection while command was running on the executor
+    bool _detached;
+
+    // Offloaded command completed, worker must continue with the input held in the buffer
+    std::atomic<bool> _resume;
+
+    // Events served since the last balancing round, used by owning worker only
+    uint64_t _events;
+
+    // Connection is registered in epoll as edge triggered, see Start
+    bool _edge;
+
+    // Socket readiness as reported by epoll, cleared once read or write would block. Write readiness
+    // gates edge triggered connection only
+    bool _readable;
+    bool _writable;
+
+    // Connection is in the run queue of the worker, used by owning worker only
+    bool _queued;
+
+    // Owning worker is serving connection and rearms it once done, so completed offloaded command
+    // leaves rearm to the worker instead of racing with it, see Hold and Rearm
+    bool _serving;
 };
 
 } // namespace MTnonblock
@@ -19,6 +19,7 @@
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
+#include <afina/concurrency/Executor.h>
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
@@ -30,7 +31,8 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode)
+    : Server(ps, pl), _mode(mode) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -47,57 +49,41 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
-    }
+    _executor.reset(new Concurrency::Executor("mt_nonblock", 1, n_workers, 1024, std::chrono::milliseconds(1000)));
 
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    if (_mode == Mode::kReusePort) {
+        StartReusePort(port, n_workers);
+        return;
     }
 
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
-    }
+    _server_socket = Listen(port, false, 5);
 
     // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
-    _event_fd = eventfd(0, EFD_NONBLOCK);
-    if (_event_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
+    if (_mode == Mode::kHandOff) {
+        StartHandOff(n_workers);
+    } else {
+        _data_epoll_fd = epoll_create1(0);
+        if (_data_epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
 
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
-    }
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
 
-    _workers.reserve(n_workers);
-    for (int i = 0; i < n_workers; i++) {
-        _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+        _workers.reserve(n_workers);
+        for (int i = 0; i < n_workers; i++) {
+            _workers.emplace_back(pStorage, pLogging);
+            _workers.back().Start(_data_epoll_fd);
+        }
     }
 
     // Start acceptors
@@ -114,6 +100,7 @@ void ServerImpl::Stop() {
     for (auto &w : _workers) {
         w.Stop();
     }
+    _executor->Stop();
 
     // Wakeup threads that are sleep on epoll_wait
     if (eventfd_write(_event_fd, 1)) {
@@ -130,6 +117,127 @@ void ServerImpl::Join() {
     for (auto &w : _workers) {
         w.Join();
     }
+
+    // Connections are handed off between workers, so they are released only once every worker is joined
+    for (auto &w : _workers) {
+        w.CloseAll();
+    }
+
+    // Offloaded commands might still be running, let them complete
+    _executor->Stop(true);
+
+    for (int socket : _worker_sockets) {
+        close(socket);
+    }
+    for (int epoll_fd : _worker_epolls) {
+        close(epoll_fd);
+    }
+    _worker_sockets.clear();
+    _worker_epolls.clear();
+}
+
+// See ServerImpl.h
+int ServerImpl::Listen(uint16_t port, bool reuse_port, int backlog) {
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    int server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    // All sockets of the group must have the option set before bind
+    if (reuse_port && (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+                       setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1)) {
+        close(server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    make_socket_non_blocking(server_socket);
+    if (listen(server_socket, backlog) == -1) {
+        close(server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+    return server_socket;
+}
+
+// See ServerImpl.h
+void ServerImpl::StartReusePort(uint16_t port, uint32_t n_workers) {
+    _workers.reserve(n_workers);
+    for (uint32_t i = 0; i < n_workers; i++) {
+        // Each socket has its own accept queue, nobody else drains it
+        int server_socket = Listen(port, true, SOMAXCONN);
+        _worker_sockets.push_back(server_socket);
+
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+        _worker_epolls.push_back(epoll_fd);
+
+        // Eventfd is never read, so stop signal wakes every worker
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        _workers.emplace_back(pStorage, pLogging);
+        _workers.back().Start(epoll_fd, server_socket, _executor.get());
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::StartHandOff(uint32_t n_workers) {
+    // Workers look at each other while balancing, so vector must not reallocate once they run
+    _workers.reserve(n_workers);
+    for (uint32_t i = 0; i < n_workers; i++) {
+        int epoll_fd = epoll_create1(0);
+        if (epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+        _worker_epolls.push_back(epoll_fd);
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        _workers.emplace_back(pStorage, pLogging);
+    }
+
+    for (uint32_t i = 0; i < n_workers; i++) {
+        _workers[i].StartHandOff(_worker_epolls[i], _executor.get(), &_workers);
+    }
+}
+
+// See ServerImpl.h
+Worker &ServerImpl::PickWorker() {
+    Worker *result = &_workers.front();
+    for (auto &w : _workers) {
+        if (w.Connections() < result->Connections() ||
+            (w.Connections() == result->Connections() && w.Load() < result->Load())) {
+            result = &w;
+        }
+    }
+    return *result;
 }
 
 // See ServerImpl.h
@@ -192,8 +300,16 @@ void ServerImpl::OnRun() {
                     _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
                 }
 
+                if (_mode == Mode::kHandOff) {
+                    if (!PickWorker().HandOff(infd, _logger)) {
+                        _logger->error("Worker inbox is full, drop connection on descriptor {}", infd);
+                        close(infd);
+                    }
+                    continue;
+                }
+
                 // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd, _logger, pStorage);
+                Connection *pc = new Connection(infd, _logger, pStorage, _executor.get(), _data_epoll_fd);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
@@ -1,6 +1,7 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <memory>
 #include <thread>
 #include <vector>
 
@@ -11,6 +12,10 @@ class logger;
 }
 
 namespace Afina {
+namespace Concurrency {
+class Executor;
+}
+
 namespace Network {
 namespace MTnonblock {
 
@@ -19,11 +24,30 @@ class Worker;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Epoll based server, works in one of three modes:
+ * - kShared: acceptor threads share single listening socket and hand connections over to the epoll
+ *   instance shared by all workers, so connection could be served by any worker
+ * - kReusePort: each worker owns SO_REUSEPORT listening socket and epoll instance, kernel spreads
+ *   connections among the sockets. Connection never leaves the worker which has accepted it, workers
+ *   share nothing but the storage. There are no acceptor threads
+ * - kHandOff: acceptors pass each connection to the worker with the least connections, every worker
+ *   owns its epoll instance. Workers periodically compare their load and the busiest one moves a few
+ *   idle connections to the least loaded peer
  */
 class ServerImpl : public Server {
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    enum class Mode {
+        // Acceptors and workers share listening socket and epoll
+        kShared,
+
+        // Listening socket and epoll per worker
+        kReusePort,
+
+        // Shared listening socket, epoll per worker
+        kHandOff
+    };
+
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode = Mode::kShared);
     ~ServerImpl();
 
     // See Server.h
@@ -40,6 +64,20 @@ protected:
     void OnNewConnection();
 
 private:
+    // Creates non blocking socket listening on the given port
+    int Listen(uint16_t port, bool reuse_port, int backlog);
+
+    // Starts workers each one having own socket and epoll, see Mode::kReusePort
+    void StartReusePort(uint16_t port, uint32_t n_workers);
+
+    // Starts workers each one having own epoll and inbox, see Mode::kHandOff
+    void StartHandOff(uint32_t n_workers);
+
+    // Worker to pass the new connection to in kHandOff mode
+    Worker &PickWorker();
+
+    const Mode _mode;
+
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
@@ -63,6 +101,13 @@ private:
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
+
+    // Listening sockets and epoll instances owned by workers in kReusePort and kHandOff modes
+    std::vector<int> _worker_sockets;
+    std::vector<int> _worker_epolls;
+
+    // threads running expensive commands on behalf of workers
+    std::unique_ptr<Concurrency::Executor> _executor;
 };
 
 } // namespace MTnonblock
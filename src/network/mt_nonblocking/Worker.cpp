@@ -1,13 +1,18 @@
 #include "Worker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
@@ -20,15 +25,23 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+constexpr std::chrono::milliseconds Worker::kBalanceInterval;
+constexpr std::size_t Worker::kMaxMigrations;
+constexpr uint64_t Worker::kMinImbalance;
+
+// Capacity of the worker inbox
+static const std::size_t kInboxSize = 1024;
+
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
-    // TODO: implementation here
-}
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _listen_socket(-1), _executor(nullptr),
+      _peers(nullptr), _inbox_fd(-1), _n_connections(0), _load(0), _events(0) {}
 
 // See Worker.h
 Worker::~Worker() {
-    // TODO: implementation here
+    if (_inbox_fd != -1) {
+        close(_inbox_fd);
+    }
 }
 
 // See Worker.h
@@ -41,21 +54,93 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _listen_socket = other._listen_socket;
+    _executor = other._executor;
+    _peers = other._peers;
+    _inbox = std::move(other._inbox);
+    _inbox_fd = other._inbox_fd;
+    _owned = std::move(other._owned);
+    _run_queue = std::move(other._run_queue);
+    _n_connections = other._n_connections.load();
+    _load = other._load.load();
+    _events = other._events;
+    _balanced_at = other._balanced_at;
 
     other._epoll_fd = -1;
+    other._listen_socket = -1;
+    other._inbox_fd = -1;
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start(int epoll_fd, int listen_socket, Concurrency::Executor *executor) {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
         _epoll_fd = epoll_fd;
+        _listen_socket = listen_socket;
+        _executor = executor;
         _logger = _pLogging->select("network.worker");
+
+        // Worker itself is the marker of listening socket events
+        if (_listen_socket != -1) {
+            struct epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = this;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _listen_socket, &event)) {
+                throw std::runtime_error("Failed to add listening socket to epoll");
+            }
+        }
+
         _thread = std::thread(&Worker::OnRun, this);
     }
 }
 
+// See Worker.h
+void Worker::StartHandOff(int epoll_fd, Concurrency::Executor *executor, std::vector<Worker> *peers) {
+    _peers = peers;
+    _inbox.reset(new Concurrency::MPMCQueue<Connection *>(kInboxSize));
+    _inbox_fd = eventfd(0, EFD_NONBLOCK);
+    if (_inbox_fd == -1) {
+        throw std::runtime_error("Failed to create eventfd: " + std::string(strerror(errno)));
+    }
+
+    // Inbox itself is the marker of its eventfd events
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = &_inbox;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, _inbox_fd, &event)) {
+        throw std::runtime_error("Failed to add inbox eventfd to epoll");
+    }
+
+    _balanced_at = std::chrono::steady_clock::now();
+    Start(epoll_fd, -1, executor);
+}
+
+// See Worker.h
+bool Worker::HandOff(int socket, std::shared_ptr<spdlog::logger> logger) {
+    Connection *pc = new Connection(socket, logger, _pStorage, _executor, _epoll_fd);
+    pc->Start(true);
+    if (!Adopt(pc)) {
+        delete pc;
+        return false;
+    }
+    return true;
+}
+
+// See Worker.h
+bool Worker::Adopt(Connection *pconn) {
+    // Counted before push, so that acceptors see the worker busier right away
+    _n_connections.fetch_add(1, std::memory_order_relaxed);
+    if (!_inbox->TryPush(pconn)) {
+        _n_connections.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (eventfd_write(_inbox_fd, 1)) {
+        _logger->error("Failed to wakeup worker: {}", strerror(errno));
+    }
+    return true;
+}
+
 // See Worker.h
 void Worker::Stop() { isRunning = false; }
 
@@ -65,6 +150,26 @@ void Worker::Join() {
     _thread.join();
 }
 
+// See Worker.h
+void Worker::CloseAll() {
+    if (!_inbox) {
+        return;
+    }
+
+    // Close erases connection from the owned set, so it goes through a copy
+    std::vector<Connection *> owned(_owned.begin(), _owned.end());
+    for (auto pconn : owned) {
+        Close(pconn);
+    }
+
+    Connection *pconn;
+    while (_inbox->TryPop(pconn)) {
+        _n_connections.fetch_sub(1, std::memory_order_relaxed);
+        close(pconn->_socket);
+        delete pconn;
+    }
+}
+
 // See Worker.h
 void Worker::OnRun() {
     assert(_epoll_fd >= 0);
@@ -74,10 +179,12 @@ void Worker::OnRun() {
     //
     // Do not forget to use EPOLLEXCLUSIVE flag when register socket
     // for events to avoid thundering herd type behavior.
-    int timeout = -1;
+    // In hand-off mode worker wakes up periodically to balance load even if it is idle
+    int timeout = _inbox ? kBalanceInterval.count() : -1;
     std::array<struct epoll_event, 64> mod_list;
     while (isRunning) {
-        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
+        // Connections in the run queue have input already, so don't sleep
+        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), _run_queue.empty() ? timeout : 0);
         _logger->debug("Worker wokeup: {} events", nmod);
 
         for (int i = 0; i < nmod; i++) {
@@ -90,43 +197,219 @@ void Worker::OnRun() {
                 continue;
             }
 
+            if (current_event.data.ptr == this) {
+                OnAccept();
+                continue;
+            }
+
+            if (current_event.data.ptr == &_inbox) {
+                OnInbox();
+                continue;
+            }
+
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
-                pconn->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pconn->DoRead();
-                pconn->DoWrite();
-                pconn->OnClose();
-            } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
-                    pconn->DoRead();
-                }
-                if (current_event.events & EPOLLOUT) {
-                    pconn->DoWrite();
-                }
+            pconn->_events++;
+            _events++;
+            Serve(pconn, current_event.events);
+        }
+
+        // Connections left with unread input continue once everybody else got a chance
+        for (std::size_t n = _run_queue.size(); n > 0; n--) {
+            Connection *pconn = _run_queue.front();
+            _run_queue.pop_front();
+            pconn->_queued = false;
+            Serve(pconn, 0);
+        }
+
+        if (_inbox && std::chrono::steady_clock::now() - _balanced_at >= kBalanceInterval) {
+            Balance();
+        }
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::Serve(Connection *pconn, uint32_t events) {
+    pconn->Hold();
+    if (events & (EPOLLIN | EPOLLRDHUP)) {
+        pconn->_readable = true;
+    }
+    if (events & EPOLLOUT) {
+        pconn->_writable = true;
+    }
+
+    bool more = false;
+    if ((events & EPOLLERR) || (events & EPOLLHUP)) {
+        pconn->OnError();
+    } else if (events & EPOLLRDHUP) {
+        pconn->DoRead();
+        pconn->DoWrite();
+        pconn->OnClose();
+    } else if (pconn->_edge) {
+        // Nothing is rearmed, so results are written right away instead of waiting for EPOLLOUT
+        pconn->_resume.exchange(false);
+        more = pconn->DoRead();
+        pconn->DoWrite();
+    } else {
+        // Depends on what connection wants... Offloaded command might have completed, then
+        // input held in the buffer must be processed as well
+        if ((events & EPOLLIN) || pconn->_resume.exchange(false)) {
+            pconn->DoRead();
+        }
+        if (events & EPOLLOUT) {
+            pconn->DoWrite();
+        }
+    }
+
+    // Rearm connection or delete closed one. Edge triggered connection won't get a new event for the
+    // input left in the socket, so it goes to the run queue instead
+    if (!pconn->Rearm()) {
+        Close(pconn);
+    } else if (more && pconn->_edge && !pconn->_queued) {
+        pconn->_queued = true;
+        _run_queue.push_back(pconn);
+    }
+}
+
+// See Worker.h
+void Worker::Close(Connection *pconn) {
+    if (pconn->isAlive()) {
+        pconn->OnError();
+    }
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
+        std::cerr << "Failed to delete connection!" << std::endl;
+    }
+    if (pconn->_queued) {
+        _run_queue.erase(std::find(_run_queue.begin(), _run_queue.end(), pconn));
+    }
+
+    // Detach marks connection under its lock. Offloaded command checks that mark under the same lock and
+    // then only deletes connection without touching descriptor, so it is closed right away: new connection
+    // reusing that number never sees writes or epoll changes of the old one. Number is saved, as connection
+    // is deleted below unless command is still running
+    int socket = pconn->_socket;
+    if (_inbox) {
+        _owned.erase(pconn);
+        _n_connections.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (pconn->Detach()) {
+        delete pconn;
+    }
+    close(socket);
+}
+
+// See Worker.h
+void Worker::OnAccept() {
+    for (;;) {
+        int infd = accept4(_listen_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                _logger->error("Failed to accept socket: {}", strerror(errno));
             }
+            break;
+        }
+        _logger->info("Accepted connection on descriptor {}", infd);
 
-            // Rearm connection
-            if (pconn->isAlive()) {
-                pconn->_event.events |= EPOLLONESHOT;
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
-                    pconn->OnError();
-                    delete pconn;
-                }
+        // Connection is registered in own epoll only, so it is served by this thread until it is closed and
+        // could be edge triggered
+        Connection *pc = new Connection(infd, _logger, _pStorage, _executor, _epoll_fd);
+        pc->Start(true);
+        if (pc->isAlive()) {
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
+                _logger->error("Failed to register descriptor {} in epoll", infd);
+                pc->OnError();
+                close(infd);
+                delete pc;
+            }
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnInbox() {
+    eventfd_t value;
+    eventfd_read(_inbox_fd, &value);
+
+    Connection *pconn;
+    while (_inbox->TryPop(pconn)) {
+        if (pconn->isAlive()) {
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pconn->_socket, &pconn->_event) == 0) {
+                _owned.insert(pconn);
+                continue;
             }
-            // Or delete closed one
-            else {
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
-                    std::cerr << "Failed to delete connection!" << std::endl;
+            _logger->error("Failed to register descriptor {} in epoll", pconn->_socket);
+            pconn->OnError();
+        }
+
+        _n_connections.fetch_sub(1, std::memory_order_relaxed);
+        close(pconn->_socket);
+        delete pconn;
+    }
+}
+
+// See Worker.h
+void Worker::Balance() {
+    uint64_t load = _events;
+    _load.store(load, std::memory_order_relaxed);
+    _events = 0;
+    _balanced_at = std::chrono::steady_clock::now();
+
+    Worker *target = nullptr;
+    for (auto &peer : *_peers) {
+        if (&peer == this) {
+            continue;
+        }
+        if (target == nullptr || peer.Load() < target->Load() ||
+            (peer.Load() == target->Load() && peer.Connections() < target->Connections())) {
+            target = &peer;
+        }
+    }
+
+    // Moving connections is worth it only if this worker is much busier than the idlest one. Peer load
+    // is one round old, so a few connections move at a time and the next round corrects the result
+    uint64_t target_load = target ? target->Load() : 0;
+    if (target != nullptr && load > 2 * target_load + kMinImbalance && _owned.size() > 1) {
+        uint64_t excess = (load - target_load) / 2;
+        for (std::size_t i = 0; i < kMaxMigrations && _owned.size() > 1; i++) {
+            // The busiest connection that doesn't overshoot the balance
+            Connection *candidate = nullptr;
+            for (auto pconn : _owned) {
+                if (pconn->_events <= excess && (candidate == nullptr || pconn->_events > candidate->_events)) {
+                    candidate = pconn;
                 }
-                delete pconn;
             }
+            if (candidate == nullptr || candidate->_events == 0) {
+                break;
+            }
+
+            // Connection in the middle of request can't move, skip it for this round
+            uint64_t served = candidate->_events;
+            candidate->_events = 0;
+            if (!candidate->Migrate(target->_epoll_fd)) {
+                continue;
+            }
+
+            epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, candidate->_socket, &candidate->_event);
+            _owned.erase(candidate);
+            _n_connections.fetch_sub(1, std::memory_order_relaxed);
+            if (!target->Adopt(candidate)) {
+                // Target inbox is full, keep connection here
+                candidate->Migrate(_epoll_fd);
+                epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, candidate->_socket, &candidate->_event);
+                _owned.insert(candidate);
+                _n_connections.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+
+            _logger->debug("Moved connection {} to another worker", candidate->_socket);
+            excess = served < excess ? excess - served : 0;
         }
-        // TODO: Select timeout...
     }
-    _logger->warn("Worker stopped");
+
+    for (auto pconn : _owned) {
+        pconn->_events = 0;
+    }
 }
 
 } // namespace MTnonblock
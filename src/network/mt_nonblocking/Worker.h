@@ -2,8 +2,14 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <afina/concurrency/MPMCQueue.h>
 
 namespace spdlog {
 class logger;
@@ -16,10 +22,16 @@ class Storage;
 namespace Logging {
 class Service;
 }
+namespace Concurrency {
+class Executor;
+}
 
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Thread running epoll
  * On Start spaws background thread that is doing epoll on the given server
@@ -37,8 +49,30 @@ public:
      * Spaws new background thread that is doing epoll on the given server
      * socket. Once connection accepted it must be registered and being processed
      * on this thread
+     *
+     * If listen_socket is given worker owns epoll_fd and accepts connections from that socket by itself,
+     * using executor for expensive commands, see ServerImpl::Mode::kReusePort
      */
-    void Start(int epoll_fd);
+    void Start(int epoll_fd, int listen_socket = -1, Concurrency::Executor *executor = nullptr);
+
+    /**
+     * Same as above, but worker owns epoll_fd and gets connections through its inbox, see HandOff. Once in
+     * a while worker compares its load with peers and moves some idle connections to the least loaded
+     * one, see ServerImpl::Mode::kHandOff
+     */
+    void StartHandOff(int epoll_fd, Concurrency::Executor *executor, std::vector<Worker> *peers);
+
+    /**
+     * Creates connection for the accepted socket and passes it to the worker thread. Could be called
+     * from any thread, returns false if inbox is full
+     */
+    bool HandOff(int socket, std::shared_ptr<spdlog::logger> logger);
+
+    // Number of connections owned by worker, including ones in the inbox
+    std::size_t Connections() const { return _n_connections.load(std::memory_order_relaxed); }
+
+    // Events served during the last balancing interval
+    uint64_t Load() const { return _load.load(std::memory_order_relaxed); }
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -54,12 +88,40 @@ public:
      */
     void Join();
 
+    /**
+     * Closes and deletes connections handed off to the worker, both registered and still in the inbox.
+     * Must be called once all workers are joined, so that nobody hands off connections anymore
+     */
+    void CloseAll();
+
 protected:
     /**
      * Method executing by background thread
      */
     void OnRun();
 
+    /**
+     * Accepts all pending connections of own listening socket and registers them in own epoll
+     */
+    void OnAccept();
+
+    /**
+     * Registers connections arrived into inbox in own epoll
+     */
+    void OnInbox();
+
+    // Handles epoll events of the connection, or continues with its input if events are 0
+    void Serve(Connection *pconn, uint32_t events);
+
+    // Unregisters and deletes closed connection
+    void Close(Connection *pconn);
+
+    // Puts connection into inbox and wakes worker up, returns false if inbox is full
+    bool Adopt(Connection *pconn);
+
+    // Publishes load of the passed interval and migrates connection to the least loaded peer if needed
+    void Balance();
+
 private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
@@ -81,6 +143,39 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Own listening socket, -1 if connections are accepted by server acceptors
+    int _listen_socket;
+
+    // Pool for the expensive commands of connections accepted by worker itself
+    Concurrency::Executor *_executor;
+
+    // How often load is compared with peers and how many connections could move at once
+    static constexpr std::chrono::milliseconds kBalanceInterval{100};
+    static constexpr std::size_t kMaxMigrations = 4;
+
+    // Load below that is never worth balancing
+    static constexpr uint64_t kMinImbalance = 64;
+
+    // Edge triggered connections with input left in the socket, used by worker thread only
+    std::deque<Connection *> _run_queue;
+
+    // All workers of the server including this one, nullptr unless started by StartHandOff
+    std::vector<Worker> *_peers;
+
+    // New and migrated connections waiting to be registered in own epoll, and eventfd signalling them
+    std::unique_ptr<Concurrency::MPMCQueue<Connection *>> _inbox;
+    int _inbox_fd;
+
+    // Connections registered in own epoll, used by worker thread only
+    std::unordered_set<Connection *> _owned;
+
+    std::atomic<std::size_t> _n_connections;
+    std::atomic<uint64_t> _load;
+
+    // Events served since the last balancing and the time of it, used by worker thread only
+    uint64_t _events;
+    std::chrono::steady_clock::time_point _balanced_at;
 };
 
 } // namespace MTnonblock
@@ -17,10 +17,12 @@
 
 #include <spdlog/logger.h>
 
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
 
+#include "network/InputBuffer.h"
 #include "protocol/Parser.h"
 
 namespace Afina {
@@ -166,21 +168,22 @@ void ServerImpl::OnRun() {
         // - execute each command
         // - send response
         try {
-            int readed_bytes = -1;
-            char client_buffer[4096];
-            while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+            ssize_t readed_bytes = -1;
+            InputBuffer<> client_buffer;
+            while ((readed_bytes = client_buffer.ReadFrom(client_socket)) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
+                Counters::Global().bytes_read.Add(readed_bytes);
 
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
                 // for example:
                 // - read#0: [<command1 start>]
                 // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-                while (readed_bytes > 0) {
-                    _logger->debug("Process {} bytes", readed_bytes);
+                while (!client_buffer.Empty()) {
+                    _logger->debug("Process {} bytes", client_buffer.Size());
                     // There is no command yet
                     if (!command_to_execute) {
                         std::size_t parsed = 0;
-                        if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                        if (parser.Parse(client_buffer.Data(), client_buffer.Chunk(), parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -195,21 +198,19 @@ void ServerImpl::OnRun() {
                         if (parsed == 0) {
                             break;
                         } else {
-                            std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                            readed_bytes -= parsed;
+                            client_buffer.Consume(parsed);
                         }
                     }
 
                     // There is command, but we still wait for argument to arrive...
                     if (command_to_execute && arg_remains > 0) {
-                        _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
+                        _logger->debug("Fill argument: {} bytes of {}", client_buffer.Size(), arg_remains);
                         // There is some parsed command, and now we are reading argument
-                        std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                        argument_for_command.append(client_buffer, to_read);
+                        std::size_t to_read = std::min(arg_remains, client_buffer.Chunk());
+                        argument_for_command.append(client_buffer.Data(), to_read);
 
-                        std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+                        client_buffer.Consume(to_read);
                         arg_remains -= to_read;
-                        readed_bytes -= to_read;
                     }
 
                     // Thre is command & argument - RUN!
@@ -224,13 +225,14 @@ void ServerImpl::OnRun() {
                         if (send(client_socket, result.data(), result.size(), 0) <= 0) {
                             throw std::runtime_error("Failed to send response");
                         }
+                        Counters::Global().bytes_written.Add(result.size());
 
                         // Prepare for the next command
                         command_to_execute.reset();
                         argument_for_command.resize(0);
                         parser.Reset();
                     }
-                } // while (readed_bytes)
+                } // while (!client_buffer.Empty())
             }
 
             if (readed_bytes == 0) {
@@ -19,6 +19,7 @@
 #include <sys/uio.h>
 
 #include <spdlog/logger.h>
+#include <afina/Counters.h>
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
 #include <afina/logging/Service.h>
@@ -38,7 +39,7 @@ void Connection::Start() {
     _event.data.ptr = this;
     _event.events = EVENT_READ;
 
-    readed_bytes = 0;
+    _read_buffer.Clear();
     _write_offset = 0;
     arg_remains = 0;
     command_to_execute = nullptr;
@@ -68,25 +69,24 @@ void Connection::DoRead() {
     _logger->info("DoRead on descriptor {}", _socket);
 
     try {
-        int readed_bytes_ = -1;
+        ssize_t readed_bytes_ = -1;
 
-        while ((readed_bytes_ = read(_socket, _read_buffer + readed_bytes, sizeof(_read_buffer) - readed_bytes)) > 0) {
+        while ((readed_bytes_ = _read_buffer.ReadFrom(_socket)) > 0) {
 
             _logger->debug("Got {} bytes from socket", readed_bytes_);
-
-            readed_bytes += readed_bytes_;
+            Counters::Global().bytes_read.Add(readed_bytes_);
 
             // Single block of data readed from the socket could trigger inside actions a multiple times,
             // for example:
             // - read#0: [<command1 start>]
             // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (readed_bytes > 0) {
-                _logger->debug("Process {} bytes", readed_bytes);
+            while (!_read_buffer.Empty()) {
+                _logger->debug("Process {} bytes", _read_buffer.Size());
 
                 // There is no command yet
                 if (!command_to_execute) {
                     std::size_t parsed = 0;
-                    if (parser.Parse(_read_buffer, readed_bytes, parsed)) {
+                    if (parser.Parse(_read_buffer.Data(), _read_buffer.Chunk(), parsed)) {
                         // There is no command to be launched, continue to parse input stream
                         // Here we are, current chunk finished some command, process it
                         _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -101,21 +101,19 @@ void Connection::DoRead() {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(_read_buffer, _read_buffer + parsed, readed_bytes - parsed);
-                        readed_bytes -= parsed;
+                        _read_buffer.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
+                    _logger->debug("Fill argument: {} bytes of {}", _read_buffer.Size(), arg_remains);
                     // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                    argument_for_command.append(_read_buffer, to_read);
+                    std::size_t to_read = std::min(arg_remains, _read_buffer.Chunk());
+                    argument_for_command.append(_read_buffer.Data(), to_read);
 
-                    std::memmove(_read_buffer, _read_buffer + to_read, readed_bytes - to_read);
+                    _read_buffer.Consume(to_read);
                     arg_remains -= to_read;
-                    readed_bytes -= to_read;
                 }
 
                 // Thre is command & argument - RUN!
@@ -140,6 +138,7 @@ void Connection::DoRead() {
                         if (send(_socket, result.data(), result.size(), 0) <= 0) {
                             throw std::runtime_error("Failed to send response about server error");
                         }
+                        Counters::Global().bytes_written.Add(result.size());
                     }
 
                     // Prepare for the next command
@@ -147,10 +146,10 @@ void Connection::DoRead() {
                     argument_for_command.resize(0);
                     parser.Reset();
                 }
-            } // while (readed_bytes)
+            } // while (!_read_buffer.Empty())
         }
 
-        if (readed_bytes == 0) {
+        if (_read_buffer.Empty()) {
             _logger->debug("Readed 0 bytes in DoRead");
         } else {
             throw std::runtime_error(std::string(strerror(errno)));
@@ -196,6 +195,7 @@ void Connection::DoWrite() {
             OnError();
             return;
         }
+        Counters::Global().bytes_written.Add(written_bytes);
 
         auto it_delete_end = _write_buffers.begin();
         if (written_bytes > 0){
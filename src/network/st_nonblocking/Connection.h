@@ -9,6 +9,7 @@
 
 #include <spdlog/logger.h>
 
+#include "network/InputBuffer.h"
 #include "protocol/Parser.h"
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
@@ -48,8 +49,7 @@ private:
 
     std::list<std::string> _write_buffers;
     std::size_t _write_offset;
-    char _read_buffer[4096];
-    int readed_bytes;
+    InputBuffer<> _read_buffer;
 
     std::size_t arg_remains;
     Protocol::Parser parser;
@@ -0,0 +1,133 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <sys/socket.h>
+
+#include <spdlog/logger.h>
+#include <afina/Counters.h>
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include "protocol/Parser.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+constexpr std::size_t Connection::kCoalesceSize;
+
+// See Connection.h
+void Connection::Start() {
+    _logger->info("Start on descriptor {}", _socket);
+    _live = true;
+
+    arg_remains = 0;
+    command_to_execute = nullptr;
+    parser = Protocol::Parser{};
+    argument_for_command.clear();
+    _input.clear();
+    _output.clear();
+}
+
+// See Connection.h
+void Connection::OnError() {
+    _logger->info("OnError on descriptor {}", _socket);
+    _live = false;
+    shutdown(_socket, SHUT_RDWR);
+    _logger->error("Error connection on descriptor {}", _socket);
+}
+
+// See Connection.h
+void Connection::OnClose() {
+    _logger->info("OnClose on descriptor {}", _socket);
+    // Client might have closed its side only, results already queued are still sent
+    _live = false;
+    _logger->debug("Closed connection on descriptor {}", _socket);
+}
+
+// See Connection.h
+void Connection::OnData(const char *data, std::size_t size) {
+    _logger->debug("Got {} bytes from socket", size);
+    Counters::Global().bytes_read.Add(size);
+
+    try {
+        // Usually the whole input is consumed right from the provided buffer, the rest is kept until
+        // the next recv
+        if (_input.empty()) {
+            std::size_t parsed = Process(data, size);
+            _input.assign(data + parsed, size - parsed);
+        } else {
+            _input.append(data, size);
+            std::size_t parsed = Process(_input.data(), _input.size());
+            _input.erase(0, parsed);
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+        OnError();
+    }
+}
+
+// See Connection.h
+std::size_t Connection::Process(const char *data, std::size_t size) {
+    // Single block of data could trigger inside actions a multiple times, see STnonblock::Connection
+    std::size_t pos = 0;
+    while (pos < size && _live) {
+        // There is no command yet
+        if (!command_to_execute) {
+            std::size_t parsed = 0;
+            if (parser.Parse(data + pos, size - pos, parsed)) {
+                _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
+                command_to_execute = parser.Build(arg_remains);
+                if (arg_remains > 0) {
+                    arg_remains += 2;
+                }
+            }
+
+            if (parsed == 0) {
+                break;
+            }
+            pos += parsed;
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (command_to_execute && arg_remains > 0) {
+            std::size_t to_read = std::min(arg_remains, size - pos);
+            argument_for_command.append(data + pos, to_read);
+            arg_remains -= to_read;
+            pos += to_read;
+        }
+
+        // Thre is command & argument - RUN!
+        if (command_to_execute && arg_remains == 0) {
+            std::string result;
+            try {
+                command_to_execute->Execute(*pStorage, argument_for_command, result);
+                result += "\r\n";
+            } catch (std::runtime_error &ex) {
+                _logger->error("Failed to Execute {}", ex.what());
+                result = "SERVER_ERROR " + std::string(ex.what()) + "\r\n";
+            }
+            Queue(std::move(result));
+
+            // Prepare for the next command
+            command_to_execute.reset();
+            argument_for_command.resize(0);
+            parser.Reset();
+        }
+    }
+    return pos;
+}
+
+// See Connection.h
+void Connection::Queue(std::string &&result) {
+    if (!_output.empty() && _output.back().size() + result.size() <= kCoalesceSize) {
+        _output.back() += result;
+    } else {
+        _output.push_back(std::move(result));
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,85 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <spdlog/logger.h>
+
+#include "protocol/Parser.h"
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Client connection
+ * Connection never reads or writes the socket itself: data is delivered by the multishot recv of the
+ * worker and results are sent by the sends it submits, see Worker
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<spdlog::logger> log, std::shared_ptr<Afina::Storage> ps)
+        : _socket(s), _logger(log), pStorage(ps), _ops(0), _receiving(false), _scheduled(false) {}
+
+    inline bool isAlive() const { return _live; }
+
+    void Start();
+
+protected:
+    void OnError();
+    void OnClose();
+
+    // Parses received data, executes complete commands and queues their results
+    void OnData(const char *data, std::size_t size);
+
+private:
+    friend class Worker;
+
+    // Results up to that size are sent by one operation, larger ones are sent as is to avoid copying
+    static constexpr std::size_t kCoalesceSize = 16 * 1024;
+
+    // Parses and executes commands from the given data, returns number of consumed bytes
+    std::size_t Process(const char *data, std::size_t size);
+
+    // Queues result of the command for sending
+    void Queue(std::string &&result);
+
+    int _socket;
+
+    std::shared_ptr<spdlog::logger> _logger;
+    std::shared_ptr<Afina::Storage> pStorage;
+
+    bool _live;
+
+    // Received data parser couldn't consume yet, usually it is empty
+    std::string _input;
+
+    // Results waiting for the next send and results being sent by linked operations in flight
+    std::deque<std::string> _output;
+    std::deque<std::string> _sending;
+
+    // Operations in flight: multishot recv and sends. Connection is deleted once all of them complete
+    int _ops;
+
+    // Multishot recv is armed
+    bool _receiving;
+
+    // Connection is in the worker list of connections with results to send
+    bool _scheduled;
+
+    std::size_t arg_remains;
+    Protocol::Parser parser;
+    std::string argument_for_command;
+    std::unique_ptr<Execute::Command> command_to_execute;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
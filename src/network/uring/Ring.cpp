@@ -0,0 +1,240 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+static inline unsigned LoadAcquire(const unsigned *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+static inline void StoreRelease(unsigned *p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+// See Ring.h
+Ring::Ring(unsigned entries)
+    : _fd(-1), _rings(MAP_FAILED), _rings_size(0), _sqes(static_cast<struct io_uring_sqe *>(MAP_FAILED)),
+      _sqes_size(0), _sq_local_tail(0), _buf_ring(static_cast<struct io_uring_buf_ring *>(MAP_FAILED)),
+      _buf_mask(0), _buf_count(0), _buffers(static_cast<char *>(MAP_FAILED)), _buffer_size(0) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    // Multishot operations post many completions per submission, so completion queue is larger
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+
+    _fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd < 0) {
+        throw std::runtime_error("Failed to setup io_uring: " + std::string(strerror(errno)));
+    }
+
+    // Older kernels are not worth the separate code path, they lack multishot operations anyway
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        close(_fd);
+        throw std::runtime_error("io_uring is too old");
+    }
+
+    _rings_size = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                           params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe));
+    _rings = mmap(nullptr, _rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_rings == MAP_FAILED) {
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+
+    _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(_rings, _rings_size);
+        close(_fd);
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+    _sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    char *rings = static_cast<char *>(_rings);
+    _sq_head = reinterpret_cast<unsigned *>(rings + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(rings + params.sq_off.tail);
+    _sq_array = reinterpret_cast<unsigned *>(rings + params.sq_off.array);
+    _sq_mask = *reinterpret_cast<unsigned *>(rings + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    _sq_local_tail = *_sq_tail;
+
+    _cq_head = reinterpret_cast<unsigned *>(rings + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(rings + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(rings + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<struct io_uring_cqe *>(rings + params.cq_off.cqes);
+
+    // SQE slots are used in order, so indirection array is identity
+    for (unsigned i = 0; i < _sq_entries; i++) {
+        _sq_array[i] = i;
+    }
+}
+
+// See Ring.h
+Ring::~Ring() {
+    // Closing descriptor cancels everything still in flight
+    close(_fd);
+    munmap(_sqes, _sqes_size);
+    munmap(_rings, _rings_size);
+    if (_buf_count > 0) {
+        munmap(_buf_ring, _buf_count * sizeof(struct io_uring_buf));
+        munmap(_buffers, _buf_count * _buffer_size);
+    }
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::GetSqe() {
+    if (_sq_local_tail - LoadAcquire(_sq_head) >= _sq_entries) {
+        int ret = Submit();
+        if (ret < 0 || _sq_local_tail - LoadAcquire(_sq_head) >= _sq_entries) {
+            throw std::runtime_error("io_uring submission queue is full");
+        }
+    }
+
+    struct io_uring_sqe *sqe = &_sqes[_sq_local_tail & _sq_mask];
+    std::memset(sqe, 0, sizeof(struct io_uring_sqe));
+    _sq_local_tail++;
+    return sqe;
+}
+
+// See Ring.h
+int Ring::Submit(unsigned wait_nr) {
+    StoreRelease(_sq_tail, _sq_local_tail);
+
+    // Entries not consumed by the previous call, e.g. interrupted one, are submitted as well
+    unsigned to_submit = _sq_local_tail - LoadAcquire(_sq_head);
+    if (to_submit == 0 && wait_nr == 0) {
+        return 0;
+    }
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret = syscall(__NR_io_uring_enter, _fd, to_submit, wait_nr, flags, nullptr, 0);
+    if (ret < 0) {
+        return (errno == EINTR || errno == EBUSY) ? 0 : -errno;
+    }
+    return ret;
+}
+
+// See Ring.h
+struct io_uring_cqe *Ring::PeekCqe() {
+    unsigned head = *_cq_head;
+    if (head == LoadAcquire(_cq_tail)) {
+        return nullptr;
+    }
+    return &_cqes[head & _cq_mask];
+}
+
+// See Ring.h
+void Ring::Advance(unsigned n) { StoreRelease(_cq_head, *_cq_head + n); }
+
+// See Ring.h
+void Ring::SetupBuffers(uint16_t bgid, unsigned count, std::size_t size) {
+    void *ring = mmap(nullptr, count * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        throw std::runtime_error("Failed to allocate buffer ring: " + std::string(strerror(errno)));
+    }
+    void *buffers = mmap(nullptr, count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        munmap(ring, count * sizeof(struct io_uring_buf));
+        throw std::runtime_error("Failed to allocate buffers: " + std::string(strerror(errno)));
+    }
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = count;
+    reg.bgid = bgid;
+    if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        int error = errno;
+        munmap(buffers, count * size);
+        munmap(ring, count * sizeof(struct io_uring_buf));
+        throw std::runtime_error("Failed to register buffer ring: " + std::string(strerror(error)));
+    }
+
+    _buf_ring = static_cast<struct io_uring_buf_ring *>(ring);
+    _buf_mask = count - 1;
+    _buf_count = count;
+    _buffers = static_cast<char *>(buffers);
+    _buffer_size = size;
+    for (unsigned bid = 0; bid < count; bid++) {
+        RecycleBuffer(bid);
+    }
+}
+
+// See Ring.h
+void Ring::RecycleBuffer(uint16_t bid) {
+    // Ring tail overlaps reserved field of the first entry, only this thread moves it. Entries are indexed
+    // from the ring start: in C++ older uapi headers place bufs after an empty struct, so it is off by 8
+    uint16_t tail = _buf_ring->tail;
+    struct io_uring_buf &buf = reinterpret_cast<struct io_uring_buf *>(_buf_ring)[tail & _buf_mask];
+    buf.addr = reinterpret_cast<uint64_t>(Buffer(bid));
+    buf.len = _buffer_size;
+    buf.bid = bid;
+    __atomic_store_n(&_buf_ring->tail, uint16_t(tail + 1), __ATOMIC_RELEASE);
+}
+
+// Runs every operation the server relies on against a socket pair
+static bool Probe() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds)) {
+        return false;
+    }
+
+    bool result = false;
+    try {
+        Ring ring(4);
+        ring.SetupBuffers(0, 2, 64);
+
+        struct io_uring_sqe *sqe = ring.GetSqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fds[0];
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->user_data = 1;
+
+        sqe = ring.GetSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = fds[1];
+        sqe->addr = reinterpret_cast<uint64_t>("x");
+        sqe->len = 1;
+        sqe->user_data = 2;
+
+        unsigned seen = 0;
+        while (seen < 2 && ring.Submit(1) >= 0) {
+            struct io_uring_cqe *cqe;
+            while ((cqe = ring.PeekCqe()) != nullptr) {
+                if (cqe->user_data == 1) {
+                    result = cqe->res == 1 && (cqe->flags & IORING_CQE_F_BUFFER) && (cqe->flags & IORING_CQE_F_MORE);
+                }
+                seen++;
+                ring.Advance(1);
+            }
+        }
+    } catch (std::runtime_error &) {
+        result = false;
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+}
+
+// See Ring.h
+bool Ring::Supported() {
+    static bool supported = Probe();
+    return supported;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
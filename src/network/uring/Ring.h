@@ -0,0 +1,103 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # io_uring instance
+ * Thin wrapper around io_uring_setup/io_uring_enter/io_uring_register system calls, there is no
+ * dependency on liburing. Submission and completion queues are shared with the kernel through mmap,
+ * so getting SQE and consuming CQE is just a memory access: the only system call is Submit.
+ *
+ * Ring isn't thread safe, it must be used by one thread at a time.
+ */
+class Ring {
+public:
+    // Throws std::runtime_error if io_uring is unavailable
+    explicit Ring(unsigned entries);
+    ~Ring();
+
+    /**
+     * Returns true if kernel supports everything the server needs: multishot accept, multishot recv
+     * with provided buffer ring and send. Checked once by the real operations on a socket pair
+     */
+    static bool Supported();
+
+    /**
+     * Returns zeroed SQE to fill, it is submitted by the next Submit call. If submission queue is full
+     * pending entries are submitted first
+     */
+    struct io_uring_sqe *GetSqe();
+
+    /**
+     * Submits all pending SQEs and waits for at least wait_nr completions. Returns number of submitted
+     * entries or -errno, EINTR and EBUSY are not errors
+     */
+    int Submit(unsigned wait_nr = 0);
+
+    // Returns next completion or nullptr, it stays in the queue until Advance
+    struct io_uring_cqe *PeekCqe();
+
+    // Releases n completions back to the kernel
+    void Advance(unsigned n);
+
+    /**
+     * Registers ring of count buffers of given size as buffer group bgid, recv with IOSQE_BUFFER_SELECT
+     * picks buffers from there. Count must be a power of two
+     */
+    void SetupBuffers(uint16_t bgid, unsigned count, std::size_t size);
+
+    // Pointer to the data of the provided buffer
+    char *Buffer(uint16_t bid) const { return _buffers + std::size_t(bid) * _buffer_size; }
+
+    // Gives buffer back to the kernel once its data is consumed
+    void RecycleBuffer(uint16_t bid);
+
+private:
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    int _fd;
+
+    // Shared rings, single mmap since IORING_FEAT_SINGLE_MMAP
+    void *_rings;
+    std::size_t _rings_size;
+
+    // Submission queue
+    unsigned *_sq_head;
+    unsigned *_sq_tail;
+    unsigned *_sq_array;
+    unsigned _sq_mask;
+    unsigned _sq_entries;
+    struct io_uring_sqe *_sqes;
+    std::size_t _sqes_size;
+
+    // Entries written by GetSqe but not yet seen by kernel
+    unsigned _sq_local_tail;
+
+    // Completion queue
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring *_buf_ring;
+    unsigned _buf_mask;
+    unsigned _buf_count;
+    char *_buffers;
+    std::size_t _buffer_size;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
@@ -0,0 +1,65 @@
+#ifndef AFINA_NETWORK_URING_SERVER_H
+#define AFINA_NETWORK_URING_SERVER_H
+
+#include <memory>
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * # Network resource manager implementation
+ * Completion based server on top of io_uring. Each worker owns SO_REUSEPORT listening socket and
+ * ring, connection never leaves the worker which has accepted it. There are no acceptor threads
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    /**
+     * Returns true if kernel supports io_uring features server relies on. Otherwise Start throws, so
+     * caller should pick another implementation
+     */
+    static bool Supported();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // Creates blocking socket listening on the given port, io_uring waits for connections by itself
+    int Listen(uint16_t port);
+
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Custom event "device" used to stop workers
+    int _event_fd;
+
+    // Listening socket of each worker
+    std::vector<int> _sockets;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_SERVER_H
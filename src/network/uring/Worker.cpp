@@ -0,0 +1,280 @@
+#include "Worker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Counters.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Ring.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+constexpr unsigned Worker::kEntries;
+constexpr uint16_t Worker::kBufferGroup;
+constexpr unsigned Worker::kBuffers;
+constexpr std::size_t Worker::kBufferSize;
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
+    : _pStorage(ps), _pLogging(pl), _listen_socket(-1), _stop_fd(-1), _accepting(false), _stopping(false) {}
+
+// See Worker.h
+Worker::~Worker() {}
+
+// See Worker.h
+void Worker::Start(int listen_socket, int stop_fd) {
+    _logger = _pLogging->select("network");
+    _listen_socket = listen_socket;
+    _stop_fd = stop_fd;
+
+    _ring.reset(new Ring(kEntries));
+    _ring->SetupBuffers(kBufferGroup, kBuffers, kBufferSize);
+
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Join() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start uring worker");
+
+    // Eventfd is never read, so one write stops every worker
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _stop_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = kStop;
+    ArmAccept();
+
+    while (!_stopping || _accepting || !_connections.empty()) {
+        // Results produced by the previous batch go out together with the wait for the next one
+        for (auto pconn : _scheduled) {
+            pconn->_scheduled = false;
+            if (pconn->_sending.empty()) {
+                Send(pconn);
+            }
+        }
+        _scheduled.clear();
+
+        int ret = _ring->Submit(1);
+        if (ret < 0) {
+            _logger->error("Failed to submit to io_uring: {}", strerror(-ret));
+            break;
+        }
+
+        unsigned seen = 0;
+        struct io_uring_cqe *cqe;
+        while ((cqe = _ring->PeekCqe()) != nullptr) {
+            uint64_t user_data = cqe->user_data;
+            int res = cqe->res;
+            uint32_t flags = cqe->flags;
+            _ring->Advance(1);
+            seen++;
+
+            if (user_data == kAccept) {
+                OnAccept(res, flags);
+            } else if (user_data == kStop) {
+                OnStop();
+            } else if (user_data != kCancel) {
+                Connection *pconn = reinterpret_cast<Connection *>(user_data & ~kKindMask);
+                if ((user_data & kKindMask) == kRecv) {
+                    OnRecv(pconn, res, flags);
+                } else {
+                    OnSend(pconn, res);
+                }
+            }
+        }
+        _logger->debug("Worker wokeup: {} completions", seen);
+    }
+
+    // Ring goes first, so that kernel doesn't touch connection buffers anymore
+    _ring.reset();
+    for (auto pconn : _connections) {
+        close(pconn->_socket);
+        delete pconn;
+    }
+    _connections.clear();
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::ArmAccept() {
+    // Blocking sockets are fine, kernel waits for readiness by itself
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _listen_socket;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = kAccept;
+    _accepting = true;
+}
+
+// See Worker.h
+void Worker::ArmRecv(Connection *pconn) {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pconn->_socket;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = reinterpret_cast<uint64_t>(pconn) | kRecv;
+    pconn->_receiving = true;
+    pconn->_ops++;
+}
+
+// See Worker.h
+void Worker::Send(Connection *pconn) {
+    pconn->_sending.swap(pconn->_output);
+
+    // MSG_WAITALL makes partial send a failure, which cancels the rest of the chain instead of sending
+    // the next result after a gap
+    std::size_t n = pconn->_sending.size();
+    for (std::size_t i = 0; i < n; i++) {
+        const std::string &buffer = pconn->_sending[i];
+        struct io_uring_sqe *sqe = _ring->GetSqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = pconn->_socket;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer.data());
+        sqe->len = buffer.size();
+        sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+        sqe->flags = i + 1 < n ? IOSQE_IO_LINK : 0;
+        sqe->user_data = reinterpret_cast<uint64_t>(pconn) | kSend;
+        pconn->_ops++;
+    }
+}
+
+// See Worker.h
+void Worker::Schedule(Connection *pconn) {
+    if (!pconn->_scheduled && !pconn->_output.empty()) {
+        pconn->_scheduled = true;
+        _scheduled.push_back(pconn);
+    }
+}
+
+// See Worker.h
+void Worker::Release(Connection *pconn) {
+    if (pconn->isAlive() || pconn->_ops > 0 || pconn->_scheduled) {
+        return;
+    }
+
+    _logger->debug("Release connection on descriptor {}", pconn->_socket);
+    close(pconn->_socket);
+    _connections.erase(pconn);
+    delete pconn;
+}
+
+// See Worker.h
+void Worker::OnAccept(int res, uint32_t flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        _accepting = false;
+    }
+
+    if (res >= 0) {
+        if (_stopping) {
+            close(res);
+        } else {
+            _logger->info("Accepted connection on descriptor {}", res);
+            Connection *pconn = new Connection(res, _logger, _pStorage);
+            pconn->Start();
+            _connections.insert(pconn);
+            ArmRecv(pconn);
+        }
+    } else if (res != -ECANCELED) {
+        _logger->error("Failed to accept socket: {}", strerror(-res));
+    }
+
+    if (!_accepting && !_stopping) {
+        ArmAccept();
+    }
+}
+
+// See Worker.h
+void Worker::OnRecv(Connection *pconn, int res, uint32_t flags) {
+    if (!(flags & IORING_CQE_F_MORE)) {
+        pconn->_receiving = false;
+        pconn->_ops--;
+    }
+
+    if (res > 0) {
+        uint16_t bid = flags >> IORING_CQE_BUFFER_SHIFT;
+        if (pconn->isAlive()) {
+            pconn->OnData(_ring->Buffer(bid), res);
+            Schedule(pconn);
+        }
+        _ring->RecycleBuffer(bid);
+    } else if (res == 0) {
+        pconn->OnClose();
+    } else if (res != -ENOBUFS && pconn->isAlive()) {
+        pconn->OnError();
+    }
+
+    // Multishot recv ends once buffers run out, they are recycled already, so it could go on
+    if (!pconn->_receiving && pconn->isAlive()) {
+        ArmRecv(pconn);
+    }
+    Release(pconn);
+}
+
+// See Worker.h
+void Worker::OnSend(Connection *pconn, int res) {
+    // Linked sends complete in order
+    pconn->_ops--;
+    pconn->_sending.pop_front();
+
+    if (res >= 0) {
+        Counters::Global().bytes_written.Add(res);
+    } else if (res != -ECANCELED) {
+        _logger->error("Failed to send to descriptor {}: {}", pconn->_socket, strerror(-res));
+        if (pconn->isAlive()) {
+            pconn->OnError();
+        }
+    }
+
+    if (pconn->_sending.empty()) {
+        Schedule(pconn);
+    }
+    Release(pconn);
+}
+
+// See Worker.h
+void Worker::OnStop() {
+    _logger->debug("Stop uring worker");
+    _stopping = true;
+
+    if (_accepting) {
+        struct io_uring_sqe *sqe = _ring->GetSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = kAccept;
+        sqe->user_data = kCancel;
+    }
+
+    // Pending operations complete right after shutdown, then connections are released
+    for (auto pconn : _connections) {
+        if (pconn->isAlive()) {
+            pconn->OnClose();
+        }
+        shutdown(pconn->_socket, SHUT_RDWR);
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,126 @@
+#ifndef AFINA_NETWORK_URING_WORKER_H
+#define AFINA_NETWORK_URING_WORKER_H
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+struct io_uring_cqe;
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Connection.h and Ring.h
+class Connection;
+class Ring;
+
+/**
+ * # Thread running io_uring
+ * Worker owns the ring, listening socket and all connections accepted from it. Everything is
+ * completion based:
+ * - multishot accept posts a completion per new connection
+ * - multishot recv of each connection posts a completion per chunk of data, kernel picks buffers
+ *   from the ring of provided buffers, so there is no buffer per connection
+ * - results are sent by linked send operations, so that several of them go out in order
+ *
+ * New operations are submitted in one batch together with the wait for completions, so under the
+ * pipelined load there is one system call for many requests
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    ~Worker();
+
+    /**
+     * Creates the ring and spawns background thread accepting connections from the listen_socket.
+     * Thread stops once stop_fd becomes readable
+     */
+    void Start(int listen_socket, int stop_fd);
+
+    // Blocks until background thread is done
+    void Join();
+
+protected:
+    void OnRun();
+
+    void OnAccept(int res, uint32_t flags);
+    void OnRecv(Connection *pconn, int res, uint32_t flags);
+    void OnSend(Connection *pconn, int res);
+
+    // Stops accepting and shuts all connections down
+    void OnStop();
+
+private:
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    // Ring size and provided buffers
+    static constexpr unsigned kEntries = 256;
+    static constexpr uint16_t kBufferGroup = 0;
+    static constexpr unsigned kBuffers = 256;
+    static constexpr std::size_t kBufferSize = 4096;
+
+    // user_data of the operations that are not tied to a connection
+    static constexpr uint64_t kAccept = 1;
+    static constexpr uint64_t kStop = 2;
+    static constexpr uint64_t kCancel = 3;
+
+    // Connection operations have connection pointer in the user_data with kind in the low bits
+    static constexpr uint64_t kRecv = 0;
+    static constexpr uint64_t kSend = 1;
+    static constexpr uint64_t kKindMask = 7;
+
+    void ArmAccept();
+    void ArmRecv(Connection *pconn);
+
+    // Submits linked sends of all queued results of the connection
+    void Send(Connection *pconn);
+
+    // Marks connection as having results to send
+    void Schedule(Connection *pconn);
+
+    // Deletes connection once it is closed and nothing is in flight
+    void Release(Connection *pconn);
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<Afina::Logging::Service> _pLogging;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    std::unique_ptr<Ring> _ring;
+    std::thread _thread;
+
+    int _listen_socket;
+    int _stop_fd;
+
+    // Multishot accept is armed
+    bool _accepting;
+
+    // Stop is requested, worker exits once connections are gone
+    bool _stopping;
+
+    std::unordered_set<Connection *> _connections;
+
+    // Connections with results to send at the end of the current batch
+    std::vector<Connection *> _scheduled;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_WORKER_H
@@ -4,6 +4,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include <afina/Counters.h>
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
 #include <afina/execute/Command.h>
@@ -168,6 +169,7 @@ std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
     }
 
     body_size = bytes;
+    Counters::Global().requests.Add();
     if (name == "set") {
         return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
     } else if (name == "add") {
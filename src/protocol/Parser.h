@@ -55,6 +55,8 @@ public:
 
     inline const std::string &Name() const { return name; }
 
+    inline const std::vector<std::string> &Keys() const { return keys; }
+
 private:
     /**
      * State of the command parser. Prefixes are:
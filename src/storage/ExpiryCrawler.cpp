@@ -0,0 +1,42 @@
+#include "ExpiryCrawler.h"
+
+namespace Afina {
+namespace Backend {
+
+// See ExpiryCrawler.h
+void ExpiryCrawler::Start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _thread = std::thread(&ExpiryCrawler::OnRun, this);
+}
+
+// See ExpiryCrawler.h
+void ExpiryCrawler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+        _stop_condition.notify_all();
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See ExpiryCrawler.h
+void ExpiryCrawler::OnRun() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        lock.unlock();
+        _step();
+        lock.lock();
+
+        _stop_condition.wait_for(lock, _tick, [this] { return !_running; });
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,60 @@
+#ifndef AFINA_STORAGE_EXPIRY_CRAWLER_H
+#define AFINA_STORAGE_EXPIRY_CRAWLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Background reclamation of expired items
+ * Owns thread which calls given step function once per tick until stopped. Step is supposed to take
+ * storage lock and check a bounded number of items, see SimpleLRU::Expire, so that crawler never holds
+ * lock for long and walks whole storage incrementally
+ */
+class ExpiryCrawler {
+public:
+    // How many index slots single step should check
+    static const std::size_t kSlotsPerTick = 4096;
+
+    ExpiryCrawler(std::function<void()> step, std::chrono::milliseconds tick = std::chrono::milliseconds(10))
+        : _step(step), _tick(tick), _running(false) {}
+    ~ExpiryCrawler() { Stop(); }
+
+    /**
+     * Spawns background thread, does nothing if crawler is running already
+     */
+    void Start();
+
+    /**
+     * Signals background thread to stop and waits until it exits
+     */
+    void Stop();
+
+private:
+    ExpiryCrawler(const ExpiryCrawler &) = delete;
+    ExpiryCrawler &operator=(const ExpiryCrawler &) = delete;
+
+    // Method executing by background thread
+    void OnRun();
+
+    std::function<void()> _step;
+    std::chrono::milliseconds _tick;
+
+    // Protects _running and used to wakeup thread on stop
+    std::mutex _mutex;
+    std::condition_variable _stop_condition;
+    bool _running;
+
+    std::thread _thread;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_EXPIRY_CRAWLER_H
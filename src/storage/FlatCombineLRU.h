@@ -0,0 +1,132 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <string>
+
+#include <afina/concurrency/FlatCombine.h>
+
+#include "ExpiryCrawler.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU behind flat combining
+ * Same semantic as ThreadSafeSimplLRU, but operations are applied in batches by a combiner thread,
+ * see Concurrency::FlatCombine. LRU list and index are touched by one core at a time for the whole
+ * batch, so hot keys don't make cache lines bounce between cores on every request.
+ */
+class FlatCombineLRU : public SimpleLRU {
+public:
+    FlatCombineLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ~FlatCombineLRU() { _crawler.Stop(); }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        Operation op(this, Operation::kPut, &key, &value, expire);
+        _combiner.Apply(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        Operation op(this, Operation::kPutIfAbsent, &key, &value, expire);
+        _combiner.Apply(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        Operation op(this, Operation::kSet, &key, &value, expire);
+        _combiner.Apply(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        Operation op(this, Operation::kDelete, &key, nullptr, 0);
+        _combiner.Apply(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        Operation op(this, Operation::kGet, &key, nullptr, 0);
+        op.out = &value;
+        _combiner.Apply(op);
+        return op.result;
+    }
+
+    // see SimpleLRU.h
+    std::size_t Expire(std::size_t max_slots) override {
+        Operation op(this, Operation::kExpire, nullptr, nullptr, 0);
+        op.slots = max_slots;
+        _combiner.Apply(op);
+        return op.removed;
+    }
+
+    // Starts background reclamation of expired items
+    void Start() override { _crawler.Start(); }
+
+    // Stops background reclamation of expired items
+    void Stop() override { _crawler.Stop(); }
+
+private:
+    // Storage call published by the caller thread and executed by the combiner
+    struct Operation {
+        enum Type { kPut, kPutIfAbsent, kSet, kDelete, kGet, kExpire };
+
+        Operation(FlatCombineLRU *storage, Type type, const std::string *key, const std::string *value,
+                  std::time_t expire)
+            : storage(storage), type(type), key(key), value(value), expire(expire), out(nullptr), slots(0),
+              result(false), removed(0) {}
+
+        void Execute() {
+            switch (type) {
+            case kPut:
+                result = storage->SimpleLRU::Put(*key, *value, expire);
+                break;
+            case kPutIfAbsent:
+                result = storage->SimpleLRU::PutIfAbsent(*key, *value, expire);
+                break;
+            case kSet:
+                result = storage->SimpleLRU::Set(*key, *value, expire);
+                break;
+            case kDelete:
+                result = storage->SimpleLRU::Delete(*key);
+                break;
+            case kGet:
+                result = storage->SimpleLRU::Get(*key, *out);
+                break;
+            case kExpire:
+                removed = storage->SimpleLRU::Expire(slots);
+                break;
+            }
+        }
+
+        FlatCombineLRU *storage;
+        Type type;
+
+        // Arguments
+        const std::string *key;
+        const std::string *value;
+        std::time_t expire;
+        std::string *out;
+        std::size_t slots;
+
+        // Results
+        bool result;
+        std::size_t removed;
+    };
+
+    Concurrency::FlatCombine<Operation> _combiner;
+
+    // Calls Expire periodically, see ExpiryCrawler.h
+    ExpiryCrawler _crawler{[this] { Expire(ExpiryCrawler::kSlotsPerTick); }};
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
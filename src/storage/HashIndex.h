@@ -0,0 +1,187 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Open addressing hash index
+ * Maps string keys to the nodes owned by somebody else. Index doesn't store keys by itself, instead
+ * it keeps full hash of the key next to the node pointer and asks KeyEqual to compare key stored in the
+ * node with the requested one only if hashes are equal.
+ *
+ * Collisions are resolved by linear probing with robin hood displacement: on insert element which is
+ * closer to its home slot gives place to the one which is farther. Thanks to that lookup for the missing
+ * key stops as soon as it meets element closer to home than the probe itself. Delete is done by backward
+ * shift, so there are no tombstones.
+ *
+ * All slots live in the single array, there is no allocation per element.
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename T, typename KeyEqual> class HashIndex {
+public:
+    HashIndex(std::size_t capacity = 16) : _slots(RoundUp(capacity)), _mask(_slots.size() - 1), _size(0) {}
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such key
+     *
+     * @param key to search for
+     * @param hash of the key
+     */
+    T *Find(const std::string &key, std::size_t hash) const {
+        std::size_t pos = Locate(hash, [this, &key](const T *value) { return _equal(*value, key); });
+        return pos == kNotFound ? nullptr : _slots[pos].value;
+    }
+
+    /**
+     * Adds new node into index. Caller must guarantee that there is no node with the same key
+     *
+     * @param value node to be added
+     * @param hash of the node key
+     */
+    void Insert(T *value, std::size_t hash) {
+        if ((_size + 1) * 8 > _slots.size() * 7) {
+            Grow();
+        }
+        Place(Slot{hash, value});
+        _size++;
+    }
+
+    /**
+     * Removes node associated with the given key from index and returns it. If there is no
+     * such key, then nullptr returned
+     *
+     * @param key to be removed
+     * @param hash of the key
+     */
+    T *Erase(const std::string &key, std::size_t hash) {
+        std::size_t pos = Locate(hash, [this, &key](const T *value) { return _equal(*value, key); });
+        return pos == kNotFound ? nullptr : EraseAt(pos);
+    }
+
+    /**
+     * Removes given node from index, returns false if node is not in the index
+     *
+     * @param value node to be removed
+     * @param hash of the node key
+     */
+    bool Erase(const T *value, std::size_t hash) {
+        std::size_t pos = Locate(hash, [value](const T *candidate) { return candidate == value; });
+        return pos == kNotFound ? false : (EraseAt(pos), true);
+    }
+
+    /**
+     * Removes all nodes from index
+     */
+    void Clear() {
+        for (auto &slot : _slots) {
+            slot = Slot{0, nullptr};
+        }
+        _size = 0;
+    }
+
+    inline std::size_t Size() const { return _size; }
+
+    // Number of slots in the table
+    inline std::size_t Capacity() const { return _slots.size(); }
+
+    /**
+     * Returns node stored in the given slot or nullptr if slot is empty. Allows to walk over all
+     * nodes without any extra state, position must be less than Capacity()
+     *
+     * @param pos slot number
+     */
+    inline T *At(std::size_t pos) const { return _slots[pos].value; }
+
+private:
+    struct Slot {
+        std::size_t hash;
+        T *value;
+    };
+
+    static const std::size_t kNotFound = std::size_t(-1);
+
+    static std::size_t RoundUp(std::size_t capacity) {
+        std::size_t result = 2;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // How far element with the given hash is from its home slot
+    inline std::size_t Distance(std::size_t hash, std::size_t pos) const { return (pos - (hash & _mask)) & _mask; }
+
+    // Position of the slot with the given hash and value matching predicate, or kNotFound
+    template <typename Pred> std::size_t Locate(std::size_t hash, Pred match) const {
+        std::size_t pos = hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            const Slot &slot = _slots[pos];
+            if (slot.value == nullptr || Distance(slot.hash, pos) < dist) {
+                return kNotFound;
+            }
+            if (slot.hash == hash && match(slot.value)) {
+                return pos;
+            }
+        }
+    }
+
+    // Remove slot at the given position, following slots are shifted back
+    T *EraseAt(std::size_t pos) {
+        T *result = _slots[pos].value;
+        for (std::size_t next = (pos + 1) & _mask; _slots[next].value != nullptr && Distance(_slots[next].hash, next) > 0;
+             pos = next, next = (next + 1) & _mask) {
+            _slots[pos] = _slots[next];
+        }
+        _slots[pos] = Slot{0, nullptr};
+        _size--;
+        return result;
+    }
+
+    // Put slot into the table using robin hood displacement, there must be at least one empty slot
+    void Place(Slot slot) {
+        std::size_t pos = slot.hash & _mask;
+        for (std::size_t dist = 0;; dist++, pos = (pos + 1) & _mask) {
+            Slot &cur = _slots[pos];
+            if (cur.value == nullptr) {
+                cur = slot;
+                return;
+            }
+
+            std::size_t cur_dist = Distance(cur.hash, pos);
+            if (cur_dist < dist) {
+                std::swap(cur, slot);
+                dist = cur_dist;
+            }
+        }
+    }
+
+    // Double number of slots and rehash all elements using stored hashes
+    void Grow() {
+        std::vector<Slot> old(_slots.size() * 2, Slot{0, nullptr});
+        old.swap(_slots);
+        _mask = _slots.size() - 1;
+
+        for (auto &slot : old) {
+            if (slot.value != nullptr) {
+                Place(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    std::size_t _mask;
+    std::size_t _size;
+    KeyEqual _equal;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
@@ -0,0 +1,160 @@
+#ifndef AFINA_STORAGE_ITEM_H
+#define AFINA_STORAGE_ITEM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+
+#include <afina/allocator/Slab.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Bits of Item::flags
+ */
+enum ItemFlags : uint32_t {
+    // Item was read since the last time eviction looked at it, see SimpleClock.h
+    kItemReferenced = 1,
+};
+
+/**
+ * # Cache item
+ * Header of the item and its key/value bytes are placed into a single memory block:
+ *
+ * [ prev | next | hash | expire | key_len | value_len | flags ][ key bytes ][ value bytes ]
+ *
+ * So that creating an item costs exactly one allocation and reading it touches memory sequentially.
+ * Item must be created by Item::Create and released by Item::Destroy only.
+ */
+struct Item {
+    // Links in the list of items, see ItemList below
+    Item *prev;
+    Item *next;
+
+    // Hash of the key, cached to avoid rehash on eviction and index growth
+    std::size_t hash;
+
+    // Unix time when item expires, 0 if never
+    std::time_t expire;
+
+    uint32_t key_len;
+    uint32_t value_len;
+
+    // Backend specific state of the item, see ItemFlags. Could be updated by concurrent readers
+    std::atomic<uint32_t> flags;
+
+    inline char *Key() { return reinterpret_cast<char *>(this + 1); }
+    inline const char *Key() const { return reinterpret_cast<const char *>(this + 1); }
+
+    inline char *Value() { return Key() + key_len; }
+    inline const char *Value() const { return Key() + key_len; }
+
+    // Number of bytes item takes from the slab: header, key and value
+    inline std::size_t BlockSize() const { return sizeof(Item) + key_len + value_len; }
+
+    inline bool KeyEquals(const std::string &key) const {
+        return key.size() == key_len && std::memcmp(Key(), key.data(), key_len) == 0;
+    }
+
+    inline void GetValue(std::string &value) const { value.assign(Value(), value_len); }
+
+    inline bool IsExpired(std::time_t now) const { return expire != 0 && expire <= now; }
+
+    // Same as above, but current time is taken only for items having expiration time
+    inline bool IsExpired() const { return expire != 0 && expire <= std::time(nullptr); }
+
+    /**
+     * Allocates new item holding copy of the given key and value from the slab. Item is not linked anywhere
+     */
+    static Item *Create(Allocator::Slab &slab, const std::string &key, const std::string &value, std::size_t hash,
+                        std::time_t expire) {
+        void *memory = slab.Allocate(sizeof(Item) + key.size() + value.size());
+        Item *item = new (memory) Item();
+        item->hash = hash;
+        item->expire = expire;
+        item->key_len = key.size();
+        item->value_len = value.size();
+        std::memcpy(item->Key(), key.data(), key.size());
+        std::memcpy(item->Value(), value.data(), value.size());
+        return item;
+    }
+
+    /**
+     * Releases item memory back to the slab it was created from, item must be unlinked already
+     */
+    static void Destroy(Allocator::Slab &slab, Item *item) {
+        std::size_t size = item->BlockSize();
+        item->~Item();
+        slab.Free(item, size);
+    }
+};
+
+/**
+ * # Intrusive list of items
+ * Circular doubly linked list with a sentinel header, so neither insert nor remove has special cases
+ * for the first/last element. List doesn't own items.
+ */
+class ItemList {
+public:
+    ItemList() : _head() { _head.prev = _head.next = &_head; }
+
+    inline bool Empty() const { return _head.next == &_head; }
+
+    // Oldest item of the list, or nullptr if list is empty
+    inline Item *Front() { return Empty() ? nullptr : _head.next; }
+
+    // Item next to the given one, or nullptr if it is the last one
+    inline Item *Next(Item *item) { return item->next == &_head ? nullptr : item->next; }
+
+    inline void PushBack(Item *item) {
+        item->prev = _head.prev;
+        item->next = &_head;
+        _head.prev->next = item;
+        _head.prev = item;
+    }
+
+    inline void Unlink(Item *item) {
+        item->prev->next = item->next;
+        item->next->prev = item->prev;
+        item->prev = item->next = nullptr;
+    }
+
+    inline void MoveToBack(Item *item) {
+        if (_head.prev != item) {
+            Unlink(item);
+            PushBack(item);
+        }
+    }
+
+    // Put new_item onto the place of old_item, which becomes unlinked
+    inline void Replace(Item *old_item, Item *new_item) {
+        new_item->prev = old_item->prev;
+        new_item->next = old_item->next;
+        new_item->prev->next = new_item;
+        new_item->next->prev = new_item;
+        old_item->prev = old_item->next = nullptr;
+    }
+
+private:
+    ItemList(const ItemList &) = delete;
+    ItemList &operator=(const ItemList &) = delete;
+
+    Item _head;
+};
+
+/**
+ * Compares key stored in the item with the given one, see HashIndex.h
+ */
+struct ItemKeyEqual {
+    bool operator()(const Item &item, const std::string &key) const { return item.KeyEquals(key); }
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ITEM_H
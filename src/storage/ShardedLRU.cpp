@@ -0,0 +1,56 @@
+#include "ShardedLRU.h"
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+// See ShardedLRU.h
+ShardedLRU::ShardedLRU(std::size_t n_shards, std::size_t max_size)
+    : _crawler([this] {
+          for (auto &shard : _shards) {
+              shard->Expire(ExpiryCrawler::kSlotsPerTick);
+          }
+      }) {
+    if (n_shards == 0) {
+        throw std::runtime_error("Number of storage shards must be positive");
+    }
+
+    _shards.reserve(n_shards);
+    for (std::size_t i = 0; i < n_shards; i++) {
+        _shards.emplace_back(new ThreadSafeSimplLRU(max_size / n_shards));
+    }
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Put(const std::string &key, const std::string &value, std::time_t expire) {
+    return Shard(key).Put(key, value, expire);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire) {
+    return Shard(key).PutIfAbsent(key, value, expire);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Set(const std::string &key, const std::string &value, std::time_t expire) {
+    return Shard(key).Set(key, value, expire);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Delete(const std::string &key) { return Shard(key).Delete(key); }
+
+// See ShardedLRU.h
+bool ShardedLRU::Get(const std::string &key, std::string &value) { return Shard(key).Get(key, value); }
+
+ThreadSafeSimplLRU &ShardedLRU::Shard(const std::string &key) {
+    // Shard is selected by the high bits of multiplicative hash, so that low bits of the key hash
+    // stay well distributed inside of each shard
+    uint64_t hash = std::hash<std::string>()(key) * 0x9E3779B97F4A7C15ull;
+    return *_shards[(hash >> 32) % _shards.size()];
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,65 @@
+#ifndef AFINA_STORAGE_SHARDED_LRU_H
+#define AFINA_STORAGE_SHARDED_LRU_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "ExpiryCrawler.h"
+#include "ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock striped version of SimpleLRU
+ * Key space is split between a number of independent SimpleLRU shards, each one has own lock
+ * and own part of the memory budget. Shard for the key is selected by the key hash, so operations
+ * on the different keys mostly don't compete for the same lock.
+ *
+ * Note that each shard evicts independently, so a single key/value pair can't be larger than
+ * max_size / n_shards bytes.
+ */
+class ShardedLRU : public Afina::Storage {
+public:
+    ShardedLRU(std::size_t n_shards = 4, std::size_t max_size = 1024);
+    ~ShardedLRU() { _crawler.Stop(); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Starts background reclamation of expired items
+    void Start() override { _crawler.Start(); }
+
+    // Stops background reclamation of expired items
+    void Stop() override { _crawler.Stop(); }
+
+private:
+    // Select shard responsible for the given key
+    ThreadSafeSimplLRU &Shard(const std::string &key);
+
+    // Independent parts of the cache, each one guarded by its own mutex
+    std::vector<std::unique_ptr<ThreadSafeSimplLRU>> _shards;
+
+    // Single crawler walks all shards one after another, so that shard locks are taken one at a time
+    ExpiryCrawler _crawler;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARDED_LRU_H
@@ -0,0 +1,45 @@
+#include "SimpleClock.h"
+
+namespace Afina {
+namespace Backend {
+
+// See SimpleClock.h
+bool SimpleClock::Get(const std::string &key, std::string &value) {
+    // Expired item can't be removed here as Get might run concurrently with other readers, so it is
+    // left for writers or Expire
+    Item *found_item = _lru_index.Find(key, _hasher(key));
+    if (found_item == nullptr || found_item->IsExpired())
+        return false;
+
+    found_item->GetValue(value);
+
+    // Check first to not make cache line dirty on each hit of the hot item
+    if ((found_item->flags.load(std::memory_order_relaxed) & kItemReferenced) == 0) {
+        found_item->flags.fetch_or(kItemReferenced, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+// See SimpleClock.h
+Item *SimpleClock::NextVictim(const Item *keep) {
+    // Each step either returns, clears one reference bit or moves keep behind the others, so loop ends
+    // after two passes at most
+    for (Item *item = _lru_list.Front(); item != nullptr; item = _lru_list.Front()) {
+        if (item == keep) {
+            if (_lru_list.Next(item) == nullptr) {
+                return nullptr;
+            }
+            _lru_list.MoveToBack(item);
+            continue;
+        }
+        if ((item->flags.load(std::memory_order_relaxed) & kItemReferenced) == 0) {
+            return item;
+        }
+        item->flags.fetch_and(~kItemReferenced, std::memory_order_relaxed);
+        _lru_list.MoveToBack(item);
+    }
+    return nullptr;
+}
+
+} // namespace Backend
+} // namespace Afina
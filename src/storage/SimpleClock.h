@@ -0,0 +1,36 @@
+#ifndef AFINA_STORAGE_SIMPLE_CLOCK_H
+#define AFINA_STORAGE_SIMPLE_CLOCK_H
+
+#include <string>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK (second chance) eviction
+ * Same as SimpleLRU, but Get doesn't reorder items. Instead hit only sets reference bit of the item,
+ * eviction walks items from the oldest one: referenced item gets bit cleared and goes to the tail,
+ * first unreferenced one is evicted.
+ *
+ * Get doesn't change anything except of atomic item flags, so it is safe to run Get concurrently
+ * with other Get calls. All other methods still requires exclusive access, see ThreadSafeClock.h
+ */
+class SimpleClock : public SimpleLRU {
+public:
+    SimpleClock(std::size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ~SimpleClock() {}
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+protected:
+    // See SimpleLRU.h
+    Item *NextVictim(const Item *keep) override;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SIMPLE_CLOCK_H
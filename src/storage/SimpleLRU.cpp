@@ -1,125 +1,178 @@
 #include "SimpleLRU.h"
-#include <assert.h>
+
+#include <vector>
+
+#include <afina/Counters.h>
 
 namespace Afina {
 namespace Backend {
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
-    return SimpleLRU::UpdateNode(key, value, _lru_index.find(key));
+bool SimpleLRU::Put(const std::string &key, const std::string &value, std::time_t expire) {
+    std::size_t hash = _hasher(key);
+    Item *found_item = FindAlive(key, hash);
+    if (expire == kKeepExpire)
+        expire = found_item == nullptr ? 0 : found_item->expire;
+    return SimpleLRU::UpdateNode(key, value, found_item, hash, expire);
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
-    if (_lru_index.find(key) != _lru_index.end())
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire) {
+    std::size_t hash = _hasher(key);
+    if (FindAlive(key, hash) != nullptr)
         return false;
-    return SimpleLRU::UpdateNode(key, value, _lru_index.end());
+    return SimpleLRU::UpdateNode(key, value, nullptr, hash, expire);
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-    const lru_map::iterator elem_it = _lru_index.find(key);
-    if (elem_it == _lru_index.end())
+bool SimpleLRU::Set(const std::string &key, const std::string &value, std::time_t expire) {
+    std::size_t hash = _hasher(key);
+    Item *found_item = FindAlive(key, hash);
+    if (found_item == nullptr)
         return false;
-    return SimpleLRU::UpdateNode(key, value, elem_it);
+    return SimpleLRU::UpdateNode(key, value, found_item, hash, expire);
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Delete(const std::string &key) {
-    const lru_map::iterator elem_it = _lru_index.find(key);
-    if (elem_it == _lru_index.end())
+    Item *found_item = FindAlive(key, _hasher(key));
+    if (found_item == nullptr)
         return false;
-    else {
-        lru_node *found_node = &(elem_it->second.get());
-        SimpleLRU::RecountCurrentSize((-1) * (found_node->key.size() + found_node->value.size()));
-        if (found_node->next != nullptr)
-            found_node->next->prev = found_node->prev;
-        _lru_index.erase(key);
-        found_node->prev->next.swap(found_node->next);
-        found_node->next.reset();
-    }
+
+    SimpleLRU::RemoveItem(found_item);
     return true;
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Get(const std::string &key, std::string &value) {
-    const lru_map::iterator elem_it = _lru_index.find(key);
-
-    if (elem_it == _lru_index.end())
+    Item *found_item = FindAlive(key, _hasher(key));
+    if (found_item == nullptr)
         return false;
-    else {
-        lru_node *found_node = &(elem_it->second.get());
-        value = found_node->value;
-        SimpleLRU::MoveToTail(found_node);
-        return true;
+
+    found_item->GetValue(value);
+    _lru_list.MoveToBack(found_item);
+    return true;
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::Expire(std::size_t max_slots) {
+    std::size_t removed = 0;
+    std::time_t now = std::time(nullptr);
+    for (std::size_t i = 0; i < max_slots; i++) {
+        if (_expire_cursor >= _lru_index.Capacity())
+            _expire_cursor = 0;
+
+        Item *item = _lru_index.At(_expire_cursor);
+        if (item != nullptr && item->IsExpired(now)) {
+            // Index might shift next item into the same slot, so it is checked once again
+            SimpleLRU::RemoveItem(item);
+            removed++;
+        } else {
+            _expire_cursor++;
+        }
     }
+    return removed;
 }
 
-bool SimpleLRU::ClearMemory(const std::size_t needed_size) {
-    if (needed_size <= _current_size) {
-        lru_node *deleted_node = _lru_head->next.get();
-        std::size_t cleared_size = deleted_node->key.size() + deleted_node->value.size();
-
-        SimpleLRU::RecountCurrentSize((-1) * cleared_size);
-        _lru_index.erase(_lru_index.find(deleted_node->key));
-        _lru_head->next.swap(deleted_node->next);
-        _lru_head->next->prev = _lru_head.get();
-        deleted_node->next.reset();
-
-        if (cleared_size >= needed_size)
-            return true;
-        else
-            return SimpleLRU::ClearMemory(needed_size - cleared_size);
-    } else
-        return false;
+Item *SimpleLRU::FindAlive(const std::string &key, std::size_t hash) {
+    Item *found_item = _lru_index.Find(key, hash);
+    if (found_item != nullptr && found_item->IsExpired()) {
+        SimpleLRU::RemoveItem(found_item);
+        return nullptr;
+    }
+    return found_item;
 }
 
-void SimpleLRU::RecountCurrentSize(const std::size_t increment) {
-    std::size_t new_size = _current_size + increment;
-    assert((new_size >= 0) & (new_size <= _max_size));
-    _current_size = new_size;
-    _empty_size -= increment;
+bool SimpleLRU::ClearMemory(const std::size_t needed_size, const Item *keep) {
+    while (_max_size - _current_size < needed_size) {
+        Item *deleted_item = NextVictim(keep);
+        if (deleted_item == nullptr)
+            return false;
+        SimpleLRU::RemoveItem(deleted_item);
+        Counters::Global().evictions.Add();
+    }
+    return true;
 }
 
-bool SimpleLRU::UpdateNode(const std::string &key, const std::string &value, const lru_map::iterator elem_it) {
-    int increment;
-    if (elem_it != _lru_index.end())
-        increment = value.size() - elem_it->second.get().value.size();
-    else
-        increment = key.size() + value.size();
-
-    if (increment <= _max_size) // to not destroy elements if we don't have enough memory after freeing
-    {
-        if (_empty_size < increment)
-            if (!SimpleLRU::ClearMemory(increment))
-                return false;
-        SimpleLRU::RecountCurrentSize(increment);
-
-        if (elem_it != _lru_index.end()) {
-            lru_node *found_node = &(elem_it->second.get());
-            found_node->value = value;
-            SimpleLRU::MoveToTail(found_node);
-        } else {
-            std::unique_ptr<lru_node> new_lru_node{new lru_node(key, value, _lru_tail)};
-            _lru_index.insert(make_pair(std::reference_wrapper<const std::string>(new_lru_node->key),
-                                        std::reference_wrapper<lru_node>(*new_lru_node)));
+void SimpleLRU::RemoveItem(Item *item) {
+    _current_size -= _allocator.BlockSize(item->BlockSize());
+    _lru_index.Erase(item, item->hash);
+    _lru_list.Unlink(item);
+    ReleaseItem(item);
+}
+
+void SimpleLRU::ReassignPage(std::size_t size, const Item *keep) {
+    // Budget of a few pages per class can't be honoured by whole pages anyway, such cache is bounded by
+    // Charge only
+    std::size_t page_size = _allocator.PageSize();
+    if (_max_size < _allocator.Classes() * page_size || !_allocator.NeedsPage(size) ||
+        _allocator.Footprint() + page_size <= _max_size)
+        return;
+
+    std::vector<void *> chunks;
+    if (!_allocator.PickDonor(size, chunks))
+        return;
+    for (void *chunk : chunks) {
+        if (chunk == keep)
+            return;
+    }
 
-            _lru_tail->next.swap(new_lru_node);
-            _lru_tail = _lru_tail->next.get();
+    // Unlinked item is waiting for deferred release already, its chunk is freed later
+    for (void *chunk : chunks) {
+        Item *item = static_cast<Item *>(chunk);
+        if (item->prev != nullptr) {
+            SimpleLRU::RemoveItem(item);
+            Counters::Global().evictions.Add();
         }
+    }
+}
+
+bool SimpleLRU::UpdateNode(const std::string &key, const std::string &value, Item *found_item, std::size_t hash,
+                           std::time_t expire) {
+    // to not destroy elements if we don't have enough memory after freeing
+    std::size_t charge = Charge(key.size(), value.size());
+    if (charge > _max_size)
+        return false;
+
+    // association expires right away, so the only visible effect is that old one is gone
+    if (expire != 0 && expire <= std::time(nullptr)) {
+        if (found_item != nullptr)
+            SimpleLRU::RemoveItem(found_item);
         return true;
-    } else
+    }
+
+    if (found_item == nullptr) {
+        if (!SimpleLRU::ClearMemory(charge))
+            return false;
+
+        SimpleLRU::ReassignPage(sizeof(Item) + key.size() + value.size(), nullptr);
+        Item *new_item = Item::Create(_allocator, key, value, hash, expire);
+        _lru_list.PushBack(new_item);
+        _lru_index.Insert(new_item, hash);
+        _current_size += charge;
+        return true;
+    }
+
+    // Updated item goes to the tail first, so that it is the last candidate for eviction
+    _lru_list.MoveToBack(found_item);
+    std::size_t old_charge = _allocator.BlockSize(found_item->BlockSize());
+    if (charge > old_charge && !SimpleLRU::ClearMemory(charge - old_charge, found_item))
         return false;
-}
 
-void SimpleLRU::MoveToTail(lru_node *found_node) {
-    if (found_node != _lru_tail) {
-        found_node->next->prev = found_node->prev;
-        found_node->prev->next.swap(found_node->next);
-        found_node->prev = _lru_tail;
-        _lru_tail->next.swap(found_node->next);
-        _lru_tail = found_node;
+    _current_size = _current_size - old_charge + charge;
+    if (value.size() == found_item->value_len) {
+        std::memcpy(found_item->Value(), value.data(), value.size());
+        found_item->expire = expire;
+    } else {
+        // Value size changed, so item has to be reallocated
+        SimpleLRU::ReassignPage(sizeof(Item) + key.size() + value.size(), found_item);
+        Item *new_item = Item::Create(_allocator, key, value, hash, expire);
+        _lru_list.Replace(found_item, new_item);
+        _lru_index.Erase(found_item, hash);
+        _lru_index.Insert(new_item, hash);
+        ReleaseItem(found_item);
     }
+    return true;
 }
 
 } // namespace Backend
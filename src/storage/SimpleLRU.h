@@ -1,18 +1,23 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 
 #include <afina/Storage.h>
+#include <afina/allocator/Slab.h>
+
+#include "HashIndex.h"
+#include "Item.h"
+#include "SwissIndex.h"
 
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # Hash index based implementation
  * That is NOT thread safe implementaiton!!
  */
 
@@ -20,26 +25,24 @@ class SimpleLRU : public Afina::Storage {
 public:
     SimpleLRU(std::size_t max_size = 1024) : _max_size(max_size) {}
 
-    ~SimpleLRU() {
-        _lru_index.clear();
+    virtual ~SimpleLRU() {
+        _lru_index.Clear();
 
-        while (_lru_head->next != nullptr) {
-            std::unique_ptr<lru_node> tmp_node{new lru_node()};
-            tmp_node.swap(_lru_head->next);
-            _lru_head->next.swap(tmp_node->next);
-            tmp_node.reset();
+        while (!_lru_list.Empty()) {
+            Item *item = _lru_list.Front();
+            _lru_list.Unlink(item);
+            Item::Destroy(_allocator, item);
         }
-        _lru_head.reset();
     }
 
     // Implements Afina::Storage interface
-    bool Put(const std::string &key, const std::string &value) override;
+    bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) override;
 
     // Implements Afina::Storage interface
-    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) override;
 
     // Implements Afina::Storage interface
-    bool Set(const std::string &key, const std::string &value) override;
+    bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) override;
 
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
@@ -47,48 +50,83 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
-private:
-    // LRU cache node
-    using lru_node = struct lru_node {
-        const std::string key;
-        std::string value;
-        lru_node *prev;
-        std::unique_ptr<lru_node> next;
+    /**
+     * Checks next max_slots slots of the index and removes expired items found there. Each call
+     * continues from the slot where previous one stopped, so repeated calls walk over all items.
+     * Returns number of removed items
+     *
+     * @param max_slots how many slots to check
+     */
+    virtual std::size_t Expire(std::size_t max_slots);
+
+    /**
+     * Returns number of bytes item with key and value of the given sizes takes from the budget: slab chunk
+     * holding its header, key and value
+     */
+    std::size_t Charge(std::size_t key_size, std::size_t value_size) const {
+        return _allocator.BlockSize(sizeof(Item) + key_size + value_size);
+    }
+
+protected:
+    // item to be evicted next, nullptr if there is no items. Item keep is being updated, so it is never
+    // returned
+    virtual Item *NextVictim(const Item *keep) {
+        Item *item = _lru_list.Front();
+        return item == keep ? _lru_list.Next(item) : item;
+    }
 
-        lru_node(const std::string key = "", std::string value = "", lru_node *prev = nullptr, lru_node *next = nullptr)
-            : key(key), value(value), prev(prev), next(next){};
-    };
+    // frees item which is unlinked from list and index already. Backend having lock-free readers could
+    // defer that until readers are gone, see afina/concurrency/Epoch.h
+    virtual void ReleaseItem(Item *item) { Item::Destroy(_allocator, item); }
 
     // Maximum number of bytes could be stored in this cache.
-    // i.e all (keys+values) must be less the _max_size
-    int _max_size;
-    int _current_size = 0;
-    int _empty_size = _max_size; // extra but usefull variable
+    // i.e all items, counted by Charge, must be less the _max_size
+    std::size_t _max_size;
+    std::size_t _current_size = 0;
 
-    // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
+    // Memory of all items comes from here, so that heap isn't fragmented by the churn of values
+    // of different sizes
+    Allocator::Slab _allocator;
+
+    // Main storage of items, elements in this list ordered descending by "freshness": in the head
     // element that wasn't used for longest time.
     //
-    // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head{new lru_node()};
-    lru_node *_lru_tail = _lru_head.get(); // quick access to tail;
+    // Cache owns all items in the list
+    ItemList _lru_list;
 
-    using lru_map =
-        std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>;
+#ifdef AFINA_STORAGE_SWISS_INDEX
+    using lru_map = SwissIndex<Item, ItemKeyEqual>;
+#else
+    using lru_map = HashIndex<Item, ItemKeyEqual>;
+#endif
 
-    // Index of nodes from list above, allows fast random access to elements by lru_node#key
+    // Index of items from list above, allows fast random access to elements by key
     lru_map _lru_index;
 
-    // clear memory for some data sizeof needed_size
-    bool ClearMemory(const std::size_t needed_size);
+    // Hash function used for the index
+    std::hash<std::string> _hasher;
+
+    // Index slot to continue Expire from
+    std::size_t _expire_cursor = 0;
+
+    // find item by key, expired item is removed and treated as missing one
+    Item *FindAlive(const std::string &key, std::size_t hash);
+
+private:
+    // evict least recently used items until there is needed_size free bytes, item keep stays
+    bool ClearMemory(const std::size_t needed_size, const Item *keep = nullptr);
 
-    // accurately recount size of _current_size and _empty_size
-    void RecountCurrentSize(const std::size_t increment);
+    // unlink item from list and index and free its memory
+    void RemoveItem(Item *item);
 
-    // delete node by key and insert new
-    bool UpdateNode(const std::string &key, const std::string &value, const lru_map::iterator elem_it);
+    // if item of the given size takes a new page while memory of the cache has reached _max_size, evicts
+    // items of the least used page of another class, so that the page is reassigned instead. Item keep
+    // isn't evicted
+    void ReassignPage(std::size_t size, const Item *keep);
 
-    // move node to tail
-    void MoveToTail(lru_node *found_node);
+    // update value of found_item or insert new item if found_item is nullptr
+    bool UpdateNode(const std::string &key, const std::string &value, Item *found_item, std::size_t hash,
+                    std::time_t expire);
 };
 
 } // namespace Backend
@@ -0,0 +1,288 @@
+#ifndef AFINA_STORAGE_SWISS_INDEX_H
+#define AFINA_STORAGE_SWISS_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Control bytes of the SwissIndex
+ * Each slot of the table has one control byte: either one of special values below or 7 low bits
+ * of the key hash if slot is occupied. Special values have high bit set, so they never match hash.
+ */
+enum SwissCtrl : int8_t { kSwissEmpty = -128, kSwissDeleted = -2 };
+
+/**
+ * Group of 16 control bytes matched in a portable way, byte by byte. Each method returns bitmask where
+ * bit i is set if control byte i matches requested condition
+ */
+struct SwissGroupScalar {
+    static const std::size_t kWidth = 16;
+
+    explicit SwissGroupScalar(const int8_t *pos) { std::memcpy(ctrl, pos, kWidth); }
+
+    uint32_t Match(int8_t h2) const {
+        uint32_t result = 0;
+        for (std::size_t i = 0; i < kWidth; i++) {
+            result |= uint32_t(ctrl[i] == h2) << i;
+        }
+        return result;
+    }
+
+    uint32_t MatchEmpty() const { return Match(kSwissEmpty); }
+
+    uint32_t MatchEmptyOrDeleted() const {
+        uint32_t result = 0;
+        for (std::size_t i = 0; i < kWidth; i++) {
+            result |= uint32_t(ctrl[i] < 0) << i;
+        }
+        return result;
+    }
+
+    int8_t ctrl[kWidth];
+};
+
+#ifdef __SSE2__
+/**
+ * Group of 16 control bytes matched all at once with SSE2 instructions
+ */
+struct SwissGroupSSE2 {
+    static const std::size_t kWidth = 16;
+
+    explicit SwissGroupSSE2(const int8_t *pos) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+    uint32_t Match(int8_t h2) const { return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)); }
+
+    uint32_t MatchEmpty() const { return Match(kSwissEmpty); }
+
+    // Both special values are negative, so it is enough to collect sign bits
+    uint32_t MatchEmptyOrDeleted() const { return _mm_movemask_epi8(ctrl); }
+
+    __m128i ctrl;
+};
+
+using SwissGroup = SwissGroupSSE2;
+#else
+using SwissGroup = SwissGroupScalar;
+#endif
+
+/**
+ * # Group probing hash index
+ * Same contract as HashIndex (see HashIndex.h), but table is split onto groups of 16 slots. Next to the
+ * slots array there is an array of one byte control values, each one keeps 7 bits of the key hash (h2).
+ * Rest of the hash bits (h1) select group to start probing from.
+ *
+ * Lookup loads whole group of control bytes and compares all 16 h2 fragments at once, full hash and key
+ * are compared only for matched candidates. Probing stops on the first group having an empty slot, so for
+ * the missing key lookup usually touches only one cache line of control bytes.
+ *
+ * Groups are probed by triangular sequence, which visits each group once as number of groups is power
+ * of two. Deleted slot is marked by tombstone unless its group has an empty slot, tombstones are dropped
+ * on the next rehash.
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename T, typename KeyEqual, typename Group = SwissGroup> class SwissIndex {
+public:
+    SwissIndex(std::size_t capacity = 16) : _size(0) { Reset(RoundUp(capacity)); }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such key
+     *
+     * @param key to search for
+     * @param hash of the key
+     */
+    T *Find(const std::string &key, std::size_t hash) const {
+        std::size_t slot = Locate(hash, [this, &key](const T *value) { return _equal(*value, key); });
+        return slot == kNotFound ? nullptr : _slots[slot].value;
+    }
+
+    /**
+     * Adds new node into index. Caller must guarantee that there is no node with the same key
+     *
+     * @param value node to be added
+     * @param hash of the node key
+     */
+    void Insert(T *value, std::size_t hash) {
+        if (_growth_left == 0) {
+            // Table is full of tombstones, it is enough to clean them up. Otherwise grow
+            Rehash(_size * 2 < Capacity() * 7 / 8 ? Capacity() : Capacity() * 2);
+        }
+
+        std::size_t slot = FindFree(hash);
+        if (_ctrl[slot] == kSwissEmpty) {
+            _growth_left--;
+        }
+        SetSlot(slot, Slot{hash, value});
+        _size++;
+    }
+
+    /**
+     * Removes node associated with the given key from index and returns it. If there is no
+     * such key, then nullptr returned
+     *
+     * @param key to be removed
+     * @param hash of the key
+     */
+    T *Erase(const std::string &key, std::size_t hash) {
+        std::size_t slot = Locate(hash, [this, &key](const T *value) { return _equal(*value, key); });
+        return slot == kNotFound ? nullptr : EraseAt(slot);
+    }
+
+    /**
+     * Removes given node from index, returns false if node is not in the index
+     *
+     * @param value node to be removed
+     * @param hash of the node key
+     */
+    bool Erase(const T *value, std::size_t hash) {
+        std::size_t slot = Locate(hash, [value](const T *candidate) { return candidate == value; });
+        return slot == kNotFound ? false : (EraseAt(slot), true);
+    }
+
+    /**
+     * Removes all nodes from index
+     */
+    void Clear() {
+        Reset(Capacity());
+        _size = 0;
+    }
+
+    inline std::size_t Size() const { return _size; }
+
+    // Number of slots in the table
+    inline std::size_t Capacity() const { return _slots.size(); }
+
+    /**
+     * Returns node stored in the given slot or nullptr if slot is empty. Allows to walk over all
+     * nodes without any extra state, position must be less than Capacity()
+     *
+     * @param pos slot number
+     */
+    inline T *At(std::size_t pos) const { return _slots[pos].value; }
+
+private:
+    struct Slot {
+        std::size_t hash;
+        T *value;
+    };
+
+    static const std::size_t kNotFound = std::size_t(-1);
+
+    static std::size_t RoundUp(std::size_t capacity) {
+        std::size_t result = Group::kWidth;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static inline int8_t H2(std::size_t hash) { return hash & 0x7F; }
+    static inline std::size_t H1(std::size_t hash) { return hash >> 7; }
+
+    // Index of the lowest set bit in the match mask
+    static inline std::size_t LowestBit(uint32_t mask) { return __builtin_ctz(mask); }
+
+    // Drop all content and prepare table of the given capacity
+    void Reset(std::size_t capacity) {
+        _ctrl.assign(capacity, kSwissEmpty);
+        _slots.assign(capacity, Slot{0, nullptr});
+        _group_mask = capacity / Group::kWidth - 1;
+        _growth_left = capacity * 7 / 8;
+    }
+
+    void SetSlot(std::size_t slot, const Slot &value) {
+        _ctrl[slot] = H2(value.hash);
+        _slots[slot] = value;
+    }
+
+    // Position of the slot with the given hash and value matching predicate, or kNotFound
+    template <typename Pred> std::size_t Locate(std::size_t hash, Pred match) const {
+        const int8_t h2 = H2(hash);
+        std::size_t group = H1(hash) & _group_mask;
+        for (std::size_t step = 1;; group = (group + step++) & _group_mask) {
+            const std::size_t base = group * Group::kWidth;
+            Group g(&_ctrl[base]);
+            for (uint32_t mask = g.Match(h2); mask != 0; mask &= mask - 1) {
+                const Slot &slot = _slots[base + LowestBit(mask)];
+                if (slot.hash == hash && match(slot.value)) {
+                    return base + LowestBit(mask);
+                }
+            }
+            if (g.MatchEmpty()) {
+                return kNotFound;
+            }
+        }
+    }
+
+    // Probe sequence never passes group with empty slot, so if there is one in the slot's group nobody
+    // could probe through this slot and it is safe to make it empty
+    T *EraseAt(std::size_t slot) {
+        T *result = _slots[slot].value;
+        std::size_t group = slot & ~(Group::kWidth - 1);
+        if (Group(&_ctrl[group]).MatchEmpty()) {
+            _ctrl[slot] = kSwissEmpty;
+            _growth_left++;
+        } else {
+            _ctrl[slot] = kSwissDeleted;
+        }
+        _slots[slot] = Slot{0, nullptr};
+        _size--;
+        return result;
+    }
+
+    // First empty or deleted slot in the probe sequence, there must be at least one
+    std::size_t FindFree(std::size_t hash) const {
+        std::size_t group = H1(hash) & _group_mask;
+        for (std::size_t step = 1;; group = (group + step++) & _group_mask) {
+            const std::size_t base = group * Group::kWidth;
+            uint32_t mask = Group(&_ctrl[base]).MatchEmptyOrDeleted();
+            if (mask != 0) {
+                return base + LowestBit(mask);
+            }
+        }
+    }
+
+    // Rebuild table with the given capacity using stored hashes
+    void Rehash(std::size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(_slots);
+        Reset(capacity);
+
+        for (auto &slot : old) {
+            if (slot.value != nullptr) {
+                SetSlot(FindFree(slot.hash), slot);
+                _growth_left--;
+            }
+        }
+    }
+
+    // Control bytes, one per slot
+    std::vector<int8_t> _ctrl;
+
+    // Nodes and their hashes
+    std::vector<Slot> _slots;
+
+    // Number of groups minus one
+    std::size_t _group_mask;
+
+    // How many empty slots could be taken before table must be rebuilt
+    std::size_t _growth_left;
+
+    std::size_t _size;
+    KeyEqual _equal;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SWISS_INDEX_H
@@ -0,0 +1,77 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_CLOCK_H
+#define AFINA_STORAGE_THREAD_SAFE_CLOCK_H
+
+#include <mutex>
+#include <string>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "ExpiryCrawler.h"
+#include "SimpleClock.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleClock thread safe version
+ * Get runs under shared lock, so readers don't block each other. Modifications and eviction are
+ * serialized by the exclusive lock
+ */
+class ThreadSafeClock : public SimpleClock {
+public:
+    ThreadSafeClock(size_t max_size = 1024) : SimpleClock(max_size) {}
+    ~ThreadSafeClock() { _crawler.Stop(); }
+
+    // see SimpleClock.h
+    bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<Concurrency::SharedMutex> guard(_global_mutex);
+        return SimpleClock::Put(key, value, expire);
+    }
+
+    // see SimpleClock.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<Concurrency::SharedMutex> guard(_global_mutex);
+        return SimpleClock::PutIfAbsent(key, value, expire);
+    }
+
+    // see SimpleClock.h
+    bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<Concurrency::SharedMutex> guard(_global_mutex);
+        return SimpleClock::Set(key, value, expire);
+    }
+
+    // see SimpleClock.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<Concurrency::SharedMutex> guard(_global_mutex);
+        return SimpleClock::Delete(key);
+    }
+
+    // see SimpleClock.h
+    bool Get(const std::string &key, std::string &value) override {
+        Concurrency::SharedLock guard(_global_mutex);
+        return SimpleClock::Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    std::size_t Expire(std::size_t max_slots) override {
+        std::lock_guard<Concurrency::SharedMutex> guard(_global_mutex);
+        return SimpleClock::Expire(max_slots);
+    }
+
+    // Starts background reclamation of expired items
+    void Start() override { _crawler.Start(); }
+
+    // Stops background reclamation of expired items
+    void Stop() override { _crawler.Stop(); }
+
+private:
+    Concurrency::SharedMutex _global_mutex;
+
+    // Calls Expire periodically, see ExpiryCrawler.h
+    ExpiryCrawler _crawler{[this] { Expire(ExpiryCrawler::kSlotsPerTick); }};
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_CLOCK_H
@@ -5,6 +5,10 @@
 #include <mutex>
 #include <string>
 
+#include <afina/concurrency/AdaptiveMutex.h>
+#include <afina/concurrency/ProfiledMutex.h>
+
+#include "ExpiryCrawler.h"
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -18,40 +22,57 @@ namespace Backend {
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
     ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
-    ~ThreadSafeSimplLRU() {}
+    ~ThreadSafeSimplLRU() { _crawler.Stop(); }
 
     // see SimpleLRU.h
-    bool Put(const std::string &key, const std::string &value) override {
-        std::lock_guard<std::mutex> guard(_global_mutex);
-        return SimpleLRU::Put(key, value);
+    bool Put(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<StorageMutex> guard(_global_mutex);
+        return SimpleLRU::Put(key, value, expire);
     }
 
     // see SimpleLRU.h
-    bool PutIfAbsent(const std::string &key, const std::string &value) override {
-        std::lock_guard<std::mutex> guard(_global_mutex);
-        return SimpleLRU::PutIfAbsent(key, value);
+    bool PutIfAbsent(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<StorageMutex> guard(_global_mutex);
+        return SimpleLRU::PutIfAbsent(key, value, expire);
     }
 
     // see SimpleLRU.h
-    bool Set(const std::string &key, const std::string &value) override {
-        std::lock_guard<std::mutex> guard(_global_mutex);
-        return SimpleLRU::Set(key, value);
+    bool Set(const std::string &key, const std::string &value, std::time_t expire = 0) override {
+        std::lock_guard<StorageMutex> guard(_global_mutex);
+        return SimpleLRU::Set(key, value, expire);
     }
 
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
-        std::lock_guard<std::mutex> guard(_global_mutex);
+        std::lock_guard<StorageMutex> guard(_global_mutex);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
-        std::lock_guard<std::mutex> guard(_global_mutex);
+        std::lock_guard<StorageMutex> guard(_global_mutex);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    std::size_t Expire(std::size_t max_slots) override {
+        std::lock_guard<StorageMutex> guard(_global_mutex);
+        return SimpleLRU::Expire(max_slots);
+    }
+
+    // Starts background reclamation of expired items
+    void Start() override { _crawler.Start(); }
+
+    // Stops background reclamation of expired items
+    void Stop() override { _crawler.Stop(); }
+
 private:
-    std::mutex _global_mutex;
+    // Either std::mutex or AdaptiveMutex, see CONCURRENCY_ADAPTIVE_MUTEX option
+    using StorageMutex = Concurrency::ProfiledMutex<Concurrency::Mutex>;
+    StorageMutex _global_mutex{"storage"};
+
+    // Calls Expire periodically, see ExpiryCrawler.h
+    ExpiryCrawler _crawler{[this] { Expire(ExpiryCrawler::kSlotsPerTick); }};
 };
 
 } // namespace Backend
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Slab.h>
+#include <afina/allocator/StlAllocator.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+TEST(ArenaTest, BumpAllocate) {
+    Arena arena(4096);
+
+    char *a = static_cast<char *>(arena.Allocate(10));
+    char *b = static_cast<char *>(arena.Allocate(10));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(max_align_t), 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(max_align_t), 0);
+    EXPECT_GE(b, a + 10);
+
+    char *c = static_cast<char *>(arena.Allocate(3, 1));
+    EXPECT_EQ(c, b + 10);
+    EXPECT_EQ(arena.Allocated(), 23);
+
+    // Only the most recent allocation is reused
+    arena.Free(c, 3);
+    EXPECT_EQ(arena.Allocate(3, 1), c);
+    arena.Free(a, 10);
+    EXPECT_EQ(arena.Allocated(), 23);
+}
+
+TEST(ArenaTest, LargeAndReset) {
+    Arena arena(4096);
+
+    char *small = static_cast<char *>(arena.Allocate(100));
+    std::size_t first_block = arena.Footprint();
+    char *large = static_cast<char *>(arena.Allocate(8192));
+    memset(large, 1, 8192);
+
+    // Dedicated block doesn't break bump allocation in the current one
+    char *next = static_cast<char *>(arena.Allocate(100));
+    EXPECT_LT(next - small, 4096);
+
+    for (int i = 0; i < 100; i++) {
+        arena.Allocate(1000);
+    }
+    EXPECT_GT(arena.Footprint(), 100 * 1000);
+
+    // Only the first bump block survives, next allocation lands there instead of taking a new one
+    arena.Reset();
+    EXPECT_EQ(arena.Allocated(), 0);
+    EXPECT_EQ(arena.Footprint(), first_block);
+    arena.Allocate(100);
+    EXPECT_EQ(arena.Footprint(), first_block);
+}
+
+TEST(ArenaTest, LargeFirstAndReset) {
+    Arena arena(4096);
+
+    arena.Allocate(8192);
+    std::size_t dedicated = arena.Footprint();
+    arena.Allocate(100);
+    std::size_t first_block = arena.Footprint() - dedicated;
+    arena.Allocate(8192);
+
+    // Dedicated block allocated before any bump one is released as well
+    arena.Reset();
+    EXPECT_EQ(arena.Footprint(), first_block);
+    arena.Allocate(100);
+    EXPECT_EQ(arena.Footprint(), first_block);
+}
+
+TEST(ArenaTest, StlContainers) {
+    Arena arena;
+
+    using IntAllocator = StlAllocator<int, Arena>;
+    vector<int, IntAllocator> v{IntAllocator(arena)};
+    for (int i = 0; i < 1000; i++) {
+        v.push_back(i);
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(v[i], i);
+    }
+
+    using String = basic_string<char, char_traits<char>, StlAllocator<char, Arena>>;
+    using MapAllocator = StlAllocator<pair<const int, String>, Arena>;
+    map<int, String, less<int>, MapAllocator> m{less<int>(), MapAllocator(arena)};
+    for (int i = 0; i < 100; i++) {
+        m.emplace(i, String(100, 'a' + i % 26, StlAllocator<char, Arena>(arena)));
+    }
+    EXPECT_EQ(m.size(), 100);
+    EXPECT_EQ(m.at(25), String(100, 'z', StlAllocator<char, Arena>(arena)));
+    EXPECT_GT(arena.Allocated(), 100 * 100);
+}
+
+TEST(ArenaTest, StlOverSlab) {
+    Slab slab(4096);
+
+    using IntAllocator = StlAllocator<int, Slab>;
+    vector<int, IntAllocator> v{IntAllocator(slab)};
+    for (int i = 0; i < 100; i++) {
+        v.push_back(i);
+    }
+    EXPECT_GT(slab.Pages(), 0);
+
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(slab.Pages(), 0);
+    EXPECT_TRUE((IntAllocator(slab) == StlAllocator<char, Slab>(slab)));
+}
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/MemPool.h>
+#include <afina/allocator/SlabCache.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+TEST(MemPoolTest, AllocFree) {
+    SlabCache cache(4096);
+    MemPool pool(100, cache);
+
+    set<void *> objects;
+    for (int i = 0; i < 1000; i++) {
+        void *p = pool.Alloc();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(max_align_t), 0);
+        memset(p, i, 100);
+        EXPECT_TRUE(objects.insert(p).second);
+    }
+    size_t slabs = pool.Slabs();
+
+    for (void *p : objects) {
+        pool.Free(p);
+    }
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(objects.count(pool.Alloc()) > 0);
+    }
+    EXPECT_EQ(pool.Slabs(), slabs);
+}
+
+TEST(MemPoolTest, SlabsReused) {
+    SlabCache cache(4096);
+    {
+        MemPool pool(64, cache);
+        for (int i = 0; i < 1000; i++) {
+            pool.Alloc();
+        }
+    }
+    size_t slabs = cache.Slabs();
+
+    MemPool pool(256, cache);
+    for (int i = 0; i < 100; i++) {
+        pool.Alloc();
+    }
+    EXPECT_EQ(cache.Slabs(), slabs);
+}
+
+TEST(MemPoolTest, CrossThreadFree) {
+    const int n_threads = 4, n_objects = 20000;
+    MemPool pool(sizeof(long));
+
+    // Each thread frees objects allocated by its neighbour, so magazines travel through the depot
+    vector<vector<long *>> objects(n_threads);
+    for (int t = 0; t < n_threads; t++) {
+        for (int i = 0; i < n_objects; i++) {
+            long *p = static_cast<long *>(pool.Alloc());
+            *p = t * n_objects + i;
+            objects[t].push_back(p);
+        }
+    }
+
+    atomic<long> errors(0);
+    vector<thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t] {
+            for (long *p : objects[(t + 1) % n_threads]) {
+                pool.Free(p);
+            }
+            vector<long *> mine;
+            for (int i = 0; i < n_objects; i++) {
+                long *p = static_cast<long *>(pool.Alloc());
+                *p = t;
+                mine.push_back(p);
+            }
+            for (long *p : mine) {
+                if (*p != t) {
+                    errors++;
+                }
+                pool.Free(p);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(errors.load(), 0);
+
+    // Everything returned, so pool doesn't need more memory for the same amount of objects
+    size_t slabs = pool.Slabs();
+    vector<void *> again;
+    for (int i = 0; i < n_threads * n_objects; i++) {
+        again.push_back(pool.Alloc());
+    }
+    EXPECT_EQ(pool.Slabs(), slabs);
+    for (void *p : again) {
+        pool.Free(p);
+    }
+}
@@ -1,4 +1,6 @@
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -322,3 +324,122 @@ TEST(SimpleTest, ReallocGrow) {
     a.free(p);
     a.free(p2);
 }
+
+TEST(SimpleTest, DefragUpdatesCopies) {
+    Simple a(buf, sizeof(buf));
+
+    int size = 100;
+    Pointer p1 = a.alloc(size);
+    Pointer p2 = a.alloc(size);
+    Pointer copy = p2;
+    writeTo(p2, size);
+
+    a.free(p1);
+    a.defrag();
+
+    EXPECT_EQ(copy.get(), p2.get());
+    EXPECT_TRUE(isDataOk(copy, size));
+
+    a.free(p2);
+    EXPECT_EQ(p2.get(), nullptr);
+}
+
+TEST(SimpleTest, InvalidFree) {
+    Simple a(buf, sizeof(buf));
+
+    Pointer p = a.alloc(100);
+    Pointer copy = p;
+    a.free(p);
+
+    try {
+        a.free(copy);
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::InvalidFree);
+    }
+}
+
+TEST(SimpleTest, DefragIncremental) {
+    Simple a(buf, sizeof(buf));
+
+    vector<Pointer> ptrs;
+    int size = 135;
+
+    ASSERT_TRUE(fillUp(a, size, ptrs));
+    for (int i = 20; i > 0; i -= 3) {
+        a.free(ptrs[i]);
+        ptrs.erase(ptrs.begin() + i);
+    }
+    EXPECT_GT(a.fragmentation(), 0.5);
+
+    // Each call moves about one block, so compaction takes many calls
+    int calls = 1;
+    while (!a.defrag(size, std::chrono::seconds(1))) {
+        calls++;
+
+        // Allocator stays usable between steps
+        Pointer p = a.alloc(size);
+        writeTo(p, size);
+        a.free(p);
+    }
+    EXPECT_GT(calls, 1);
+    EXPECT_EQ(a.fragmentation(), 0.0);
+
+    Pointer newPtr = a.alloc(size * 2);
+    writeTo(newPtr, size * 2);
+    EXPECT_TRUE(isDataOk(newPtr, size * 2));
+
+    for (Pointer &p : ptrs) {
+        EXPECT_TRUE(isDataOk(p, size));
+        a.free(p);
+    }
+    a.free(newPtr);
+}
+
+// Block grown in place swallows the free block incremental defrag stopped at
+TEST(SimpleTest, DefragAfterReallocInplace) {
+    Simple a(buf, sizeof(buf));
+
+    vector<Pointer> ptrs;
+    for (int i = 0; i < 5; i++) {
+        ptrs.push_back(a.alloc(64));
+        writeTo(ptrs.back(), 64);
+    }
+    a.free(ptrs[1]);
+    a.free(ptrs[3]);
+    EXPECT_FALSE(a.defrag(1, std::chrono::seconds(1)));
+
+    a.realloc(ptrs[2], 100);
+    memset(ptrs[2].get(), 0x7f, 100);
+    EXPECT_TRUE(a.defrag(1 << 20, std::chrono::seconds(1)));
+    EXPECT_EQ(a.fragmentation(), 0.0);
+
+    char *v = reinterpret_cast<char *>(ptrs[2].get());
+    EXPECT_EQ(100, count(v, v + 100, 0x7f));
+    EXPECT_TRUE(isDataOk(ptrs[0], 64));
+    EXPECT_TRUE(isDataOk(ptrs[4], 64));
+}
+
+// Last block grown into the gap covers the place where finished defrag stopped
+TEST(SimpleTest, DefragAfterReallocIntoGap) {
+    Simple a(buf, sizeof(buf));
+
+    Pointer p1 = a.alloc(64), p2 = a.alloc(64), p3 = a.alloc(64);
+    writeTo(p1, 64);
+    a.free(p2);
+    EXPECT_TRUE(a.defrag(1 << 20, std::chrono::seconds(1)));
+
+    // Zeroed payload would look like a free block header
+    a.realloc(p3, 1000);
+    memset(p3.get(), 0, 1000);
+    Pointer p4 = a.alloc(64);
+    writeTo(p4, 64);
+    EXPECT_TRUE(a.defrag(1 << 20, std::chrono::seconds(1)));
+
+    char *v = reinterpret_cast<char *>(p3.get());
+    EXPECT_EQ(1000, count(v, v + 1000, 0));
+    EXPECT_TRUE(isDataOk(p1, 64));
+    EXPECT_TRUE(isDataOk(p4, 64));
+    a.free(p3);
+    a.free(p4);
+}
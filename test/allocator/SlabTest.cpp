@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include <afina/allocator/Slab.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+TEST(SlabTest, ClassesGrow) {
+    Slab slab(4096);
+
+    ASSERT_GT(slab.Classes(), 1);
+    for (size_t i = 1; i < slab.Classes(); i++) {
+        EXPECT_GT(slab.ChunkSize(i), slab.ChunkSize(i - 1));
+        EXPECT_EQ(slab.ChunkSize(i) % alignof(max_align_t), 0);
+    }
+}
+
+TEST(SlabTest, ChunksDontOverlap) {
+    Slab slab(4096);
+    vector<pair<char *, size_t>> blocks;
+
+    for (size_t i = 0; i < 300; i++) {
+        size_t size = 1 + (i * 37) % 700;
+        char *p = static_cast<char *>(slab.Allocate(size));
+        memset(p, i, size);
+        blocks.emplace_back(p, size);
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++) {
+        for (size_t j = 0; j < blocks[i].second; j++) {
+            ASSERT_EQ(blocks[i].first[j], char(i));
+        }
+        slab.Free(blocks[i].first, blocks[i].second);
+    }
+    EXPECT_EQ(slab.Pages(), 0);
+}
+
+TEST(SlabTest, ReuseFreedChunk) {
+    Slab slab(4096);
+
+    void *a = slab.Allocate(100);
+    void *b = slab.Allocate(100);
+    slab.Free(a, 100);
+    void *c = slab.Allocate(90);
+
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(slab.Pages(), 1);
+
+    slab.Free(b, 100);
+    slab.Free(c, 90);
+}
+
+TEST(SlabTest, PageReassignment) {
+    Slab slab(4096, 1.25, 16);
+    set<void *> small;
+
+    // Fill a few pages of the smallest class and release them all
+    while (slab.Pages() < 8) {
+        small.insert(slab.Allocate(64));
+    }
+    size_t footprint = slab.Footprint();
+    for (void *p : small) {
+        slab.Free(p, 64);
+    }
+    EXPECT_EQ(slab.Pages(), 0);
+    EXPECT_EQ(slab.SparePages(), 8);
+
+    // Pages are taken by another class without asking system for more memory
+    vector<void *> big;
+    while (slab.SparePages() > 0) {
+        big.push_back(slab.Allocate(500));
+    }
+    EXPECT_EQ(slab.Footprint(), footprint);
+    EXPECT_EQ(slab.Pages(), 8);
+
+    for (void *p : big) {
+        slab.Free(p, 500);
+    }
+}
+
+TEST(SlabTest, PickDonor) {
+    Slab slab(4096, 1.25, 0);
+    EXPECT_EQ(slab.BlockSize(50), slab.ChunkSize(0));
+    EXPECT_EQ(slab.BlockSize(10 * 4096), 10 * 4096);
+
+    // Two pages of the small class, the second one has a single chunk left after frees
+    vector<void *> small;
+    while (slab.Pages() < 2) {
+        small.push_back(slab.Allocate(64));
+    }
+    size_t per_page = small.size() - 1;
+    for (int i = 0; i < 4; i++) {
+        small.push_back(slab.Allocate(64));
+    }
+    for (size_t i = per_page; i + 1 < small.size(); i++) {
+        slab.Free(small[i], 64);
+    }
+    EXPECT_FALSE(slab.NeedsPage(64));
+    EXPECT_TRUE(slab.NeedsPage(500));
+
+    vector<void *> chunks;
+    ASSERT_TRUE(slab.PickDonor(500, chunks));
+    ASSERT_EQ(chunks.size(), 1);
+    EXPECT_EQ(chunks[0], small.back());
+
+    // Once its chunks are freed page goes to the class which needed it
+    slab.Free(chunks[0], 64);
+    EXPECT_EQ(slab.Pages(), 1);
+    void *big = slab.Allocate(500);
+    EXPECT_EQ(slab.Pages(), 2);
+
+    slab.Free(big, 500);
+    for (size_t i = 0; i < per_page; i++) {
+        slab.Free(small[i], 64);
+    }
+    EXPECT_EQ(slab.Pages(), 0);
+}
+
+TEST(SlabTest, LargeBlock) {
+    Slab slab(4096);
+
+    size_t size = 10 * 4096;
+    char *p = static_cast<char *>(slab.Allocate(size));
+    memset(p, 1, size);
+    EXPECT_EQ(slab.Pages(), 0);
+    EXPECT_EQ(slab.Footprint(), size);
+
+    slab.Free(p, size);
+    EXPECT_EQ(slab.Footprint(), 0);
+}
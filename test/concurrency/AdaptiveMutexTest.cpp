@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/AdaptiveMutex.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+TEST(AdaptiveMutexTest, MutualExclusion) {
+    const int n_threads = 8, n_ops = 100000;
+    AdaptiveMutex mutex;
+    long counter = 0;
+
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < n_ops; j++) {
+                std::lock_guard<AdaptiveMutex> lock(mutex);
+                counter++;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(counter, n_threads * n_ops);
+    LockStats stats = mutex.Stats();
+    EXPECT_EQ(stats.acquisitions, n_threads * n_ops);
+    EXPECT_LE(stats.contended, stats.acquisitions);
+    EXPECT_EQ(stats.hold_samples, n_threads * n_ops / AdaptiveMutex::kHoldSampleRate);
+}
+
+TEST(AdaptiveMutexTest, TryLock) {
+    AdaptiveMutex mutex;
+    EXPECT_TRUE(mutex.try_lock());
+
+    thread other([&mutex] { EXPECT_FALSE(mutex.try_lock()); });
+    other.join();
+
+    mutex.unlock();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_EQ(mutex.Stats().acquisitions, 2);
+}
+
+TEST(AdaptiveMutexTest, ParksLongWaiter) {
+    AdaptiveMutex mutex;
+    mutex.lock();
+
+    atomic<bool> started(false);
+    thread waiter([&] {
+        started = true;
+        std::lock_guard<AdaptiveMutex> lock(mutex);
+    });
+
+    // Holder keeps lock much longer than spins last, so waiter has to sleep
+    while (!started) {
+        this_thread::yield();
+    }
+    this_thread::sleep_for(chrono::milliseconds(50));
+    mutex.unlock();
+    waiter.join();
+
+    LockStats stats = mutex.Stats();
+    EXPECT_EQ(stats.contended, 1);
+    EXPECT_GE(stats.parks, 1);
+    EXPECT_GE(stats.wait_ns, 10 * 1000 * 1000);
+}
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+// Much more threads than cores, so that they are preempted and migrated inside of critical sections
+static const int n_threads = 16;
+
+static void CheckCounter(bool use_rseq) {
+    const int n_ops = 200000;
+    CoreCounter counter(use_rseq);
+
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < n_ops; j++) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(counter.Read(), n_threads * n_ops);
+}
+
+struct Node {
+    Node *next;
+    int id;
+};
+
+static void CheckFreeList(bool use_rseq) {
+    const int n_nodes = 1000, n_ops = 100000;
+    CoreFreeList<Node> list(use_rseq);
+    vector<Node> nodes(n_nodes);
+    for (int i = 0; i < n_nodes; i++) {
+        nodes[i].id = i;
+        list.Push(&nodes[i]);
+    }
+
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&list] {
+            vector<Node *> taken;
+            for (int j = 0; j < n_ops; j++) {
+                if (j % 3 != 2) {
+                    Node *node = list.Pop();
+                    if (node != nullptr) {
+                        taken.push_back(node);
+                    }
+                } else if (!taken.empty()) {
+                    list.Push(taken.back());
+                    taken.pop_back();
+                }
+            }
+            for (Node *node : taken) {
+                list.Push(node);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Each node is back exactly once
+    set<int> seen;
+    list.ForEach([&seen](Node *node) { EXPECT_TRUE(seen.insert(node->id).second); });
+    EXPECT_EQ(seen.size(), n_nodes);
+}
+
+TEST(CoreLocalTest, Instances) {
+    CoreLocal<int> local;
+    EXPECT_GE(local.Size(), 1);
+    EXPECT_LT(local.Cpu(), local.Size());
+    local.ForEach([](int &value) { value = 1; });
+    EXPECT_EQ(local.Get(), 1);
+
+    // Each instance starts its own cache line
+    for (size_t i = 0; i < local.Size(); i++) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(&local.At(i)) % 64, 0);
+    }
+}
+
+TEST(CoreLocalTest, CounterFallback) { CheckCounter(false); }
+
+TEST(CoreLocalTest, CounterRseq) {
+    if (!Rseq::Available()) {
+        return;
+    }
+    CheckCounter(true);
+}
+
+TEST(CoreLocalTest, FreeListFallback) { CheckFreeList(false); }
+
+TEST(CoreLocalTest, FreeListRseq) {
+    if (!Rseq::Available()) {
+        return;
+    }
+    CheckFreeList(true);
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Epoch.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+// Object which is marked instead of being freed, so that readers could detect premature reclamation
+struct Node {
+    atomic<bool> alive{true};
+    int value = 0;
+};
+
+static void MarkFreed(void *object, void *freed) {
+    static_cast<Node *>(object)->alive.store(false);
+    static_cast<atomic<int> *>(freed)->fetch_add(1);
+}
+
+// Collects until all retired objects are freed or attempts are over
+static void CollectAll(EpochDomain &domain) {
+    for (int i = 0; i < 100 && domain.Pending() > 0; i++) {
+        domain.Collect();
+    }
+}
+
+TEST(EpochTest, GuardDefersFree) {
+    EpochDomain domain;
+    atomic<int> freed(0);
+    Node node;
+
+    {
+        auto guard = domain.Pin();
+        // Nested guard keeps thread pinned after it is gone
+        { auto nested = domain.Pin(); }
+
+        thread writer([&] {
+            domain.Retire(&node, MarkFreed, &freed);
+            CollectAll(domain);
+        });
+        writer.join();
+
+        EXPECT_TRUE(node.alive.load());
+        EXPECT_EQ(domain.Pending(), 1);
+    }
+
+    CollectAll(domain);
+    EXPECT_FALSE(node.alive.load());
+    EXPECT_EQ(freed.load(), 1);
+    EXPECT_EQ(domain.Pending(), 0);
+}
+
+TEST(EpochTest, ConcurrentReaders) {
+    const int n_readers = 4, n_writes = 20000;
+    vector<unique_ptr<Node>> nodes;
+    for (int i = 0; i <= n_writes; i++) {
+        nodes.emplace_back(new Node());
+        nodes.back()->value = i;
+    }
+
+    atomic<int> freed(0);
+    {
+        EpochDomain domain;
+        domain.Start(chrono::milliseconds(1));
+
+        atomic<Node *> current(nodes[0].get());
+        atomic<bool> done(false);
+        atomic<int> failures(0);
+
+        vector<thread> readers;
+        for (int i = 0; i < n_readers; i++) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    auto guard = domain.Pin();
+                    Node *node = current.load();
+                    for (int j = 0; j < 16; j++) {
+                        if (!node->alive.load()) {
+                            failures++;
+                        }
+                    }
+                }
+            });
+        }
+
+        for (int i = 1; i <= n_writes; i++) {
+            Node *old = current.exchange(nodes[i].get());
+            domain.Retire(old, MarkFreed, &freed);
+            if (i % 64 == 0) {
+                domain.Collect();
+            }
+        }
+        done = true;
+        for (auto &t : readers) {
+            t.join();
+        }
+
+        EXPECT_EQ(failures.load(), 0);
+        EXPECT_GT(freed.load(), 0);
+    }
+
+    // Domain frees the rest on destruction
+    EXPECT_EQ(freed.load(), n_writes);
+    EXPECT_TRUE(nodes[n_writes]->alive.load());
+}
+
+TEST(EpochTest, RetiredByExitedThread) {
+    EpochDomain domain;
+    atomic<int> freed(0);
+    vector<unique_ptr<Node>> nodes(10);
+
+    thread writer([&] {
+        for (auto &node : nodes) {
+            node.reset(new Node());
+            domain.Retire(node.get(), MarkFreed, &freed);
+        }
+    });
+    writer.join();
+
+    EXPECT_EQ(domain.Pending(), nodes.size());
+    CollectAll(domain);
+    EXPECT_EQ(freed.load(), nodes.size());
+}
+
+TEST(EpochTest, BackgroundCollect) {
+    EpochDomain domain;
+    domain.Start(chrono::milliseconds(1));
+
+    for (int i = 0; i < 10; i++) {
+        domain.Retire(new Node());
+    }
+    for (int i = 0; i < 1000 && domain.Pending() > 0; i++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(domain.Pending(), 0);
+    EXPECT_GE(domain.Epoch(), 2);
+}
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+TEST(ExecutorTest, ExecuteAll) {
+    atomic<int> done(0);
+    {
+        Executor executor("test", 1, 4, 1000, chrono::milliseconds(100));
+        for (int i = 0; i < 1000; i++) {
+            while (!executor.Execute([&done](int n) { done += n; }, 1)) {
+                this_thread::yield();
+            }
+        }
+        executor.Stop(true);
+        EXPECT_FALSE(executor.Execute([] {}));
+    }
+    EXPECT_EQ(done.load(), 1000);
+}
+
+TEST(ExecutorTest, Watermarks) {
+    Executor executor("test", 1, 3, 100, chrono::milliseconds(50));
+    EXPECT_EQ(executor.Threads(), 1);
+
+    // Blocked tasks force pool to grow up to high watermark, but not above it
+    mutex m;
+    condition_variable cv;
+    bool release = false;
+    auto blocker = [&] {
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return release; });
+    };
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(executor.Execute(blocker));
+    }
+    EXPECT_EQ(executor.Threads(), 3);
+
+    {
+        unique_lock<mutex> lock(m);
+        release = true;
+        cv.notify_all();
+    }
+
+    // Idle threads exit down to low watermark
+    for (int i = 0; i < 100 && executor.Threads() > 1; i++) {
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+    EXPECT_EQ(executor.Threads(), 1);
+}
+
+TEST(ExecutorTest, BoundedQueue) {
+    Executor executor("test", 1, 1, 2, chrono::milliseconds(50));
+
+    mutex m;
+    condition_variable cv;
+    bool release = false;
+    atomic<bool> started(false);
+    EXPECT_TRUE(executor.Execute([&] {
+        started = true;
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return release; });
+    }));
+    while (!started) {
+        this_thread::yield();
+    }
+
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_FALSE(executor.Execute([] {}));
+    EXPECT_EQ(executor.QueueSize(), 2);
+
+    {
+        unique_lock<mutex> lock(m);
+        release = true;
+        cv.notify_all();
+    }
+    executor.Stop(true);
+    EXPECT_EQ(executor.QueueSize(), 0);
+}
+
+// Each task splits itself until depth is exhausted, so most tasks are submitted by pool threads
+static void Spawn(Executor &executor, atomic<int> &done, int depth) {
+    done++;
+    if (depth > 0) {
+        for (int i = 0; i < 2; i++) {
+            while (!executor.Execute(Spawn, std::ref(executor), std::ref(done), depth - 1)) {
+                this_thread::yield();
+            }
+        }
+    }
+}
+
+TEST(ExecutorTest, StealingExecuteAll) {
+    atomic<int> done(0);
+    Executor executor("test", 1, 4, 100000, chrono::milliseconds(100), Executor::Mode::kStealing);
+    EXPECT_EQ(executor.Threads(), 4);
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(executor.Execute([&done](int n) { done += n; }, 1));
+    }
+    EXPECT_TRUE(executor.Execute(Spawn, std::ref(executor), std::ref(done), 12));
+
+    // Stop waits for tasks spawned by other tasks as well
+    while (done.load() < 1000 + (1 << 13) - 1) {
+        this_thread::yield();
+    }
+    executor.Stop(true);
+    EXPECT_FALSE(executor.Execute([] {}));
+    EXPECT_EQ(done.load(), 1000 + (1 << 13) - 1);
+    EXPECT_EQ(executor.QueueSize(), 0);
+}
+
+TEST(ExecutorTest, StealingParkAndWake) {
+    Executor executor("test", 1, 4, 1000, chrono::milliseconds(100), Executor::Mode::kStealing);
+    for (int round = 0; round < 20; round++) {
+        // Let all threads park, then check that a single task wakes one of them up
+        this_thread::sleep_for(chrono::milliseconds(2));
+        atomic<bool> done(false);
+        EXPECT_TRUE(executor.Execute([&done] { done = true; }));
+        while (!done) {
+            this_thread::yield();
+        }
+    }
+}
+
+TEST(ExecutorTest, StealingBoundedQueue) {
+    Executor executor("test", 1, 1, 2, chrono::milliseconds(50), Executor::Mode::kStealing);
+
+    mutex m;
+    condition_variable cv;
+    bool release = false;
+    atomic<bool> started(false);
+    EXPECT_TRUE(executor.Execute([&] {
+        started = true;
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return release; });
+    }));
+    while (!started) {
+        this_thread::yield();
+    }
+
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_FALSE(executor.Execute([] {}));
+    EXPECT_EQ(executor.QueueSize(), 2);
+
+    {
+        unique_lock<mutex> lock(m);
+        release = true;
+        cv.notify_all();
+    }
+    executor.Stop(true);
+    EXPECT_EQ(executor.QueueSize(), 0);
+}
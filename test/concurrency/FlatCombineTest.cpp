@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+// Increments plain counter, which is safe only if operations are serialized
+struct Increment {
+    void Execute() {
+        if (fail) {
+            throw runtime_error("failed");
+        }
+        result = ++*counter;
+    }
+
+    long *counter;
+    bool fail;
+    long result;
+};
+
+TEST(FlatCombineTest, Serializes) {
+    const int n_threads = 8, n_ops = 20000;
+    FlatCombine<Increment> combiner;
+    long counter = 0;
+
+    vector<thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&] {
+            long last = 0;
+            for (int i = 0; i < n_ops; i++) {
+                Increment op{&counter, false, 0};
+                combiner.Apply(op);
+                // Results are handed back to the right thread and grow monotonically
+                EXPECT_GT(op.result, last);
+                last = op.result;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(counter, n_threads * n_ops);
+}
+
+TEST(FlatCombineTest, Exception) {
+    FlatCombine<Increment> combiner;
+    long counter = 0;
+
+    Increment bad{&counter, true, 0};
+    EXPECT_THROW(combiner.Apply(bad), runtime_error);
+
+    Increment good{&counter, false, 0};
+    combiner.Apply(good);
+    EXPECT_EQ(good.result, 1);
+}
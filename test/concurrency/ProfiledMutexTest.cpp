@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/AdaptiveMutex.h>
+#include <afina/concurrency/ProfiledMutex.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+static LockProfile::Snapshot Find(const string &name) {
+    for (auto &snapshot : LockProfile::ReadAll()) {
+        if (snapshot.name == name) {
+            return snapshot;
+        }
+    }
+    return LockProfile::Snapshot();
+}
+
+TEST(ProfiledMutexTest, DisabledByDefault) {
+    ProfiledMutex<> mutex("test.disabled");
+    for (int i = 0; i < 10; i++) {
+        std::lock_guard<ProfiledMutex<>> lock(mutex);
+    }
+    EXPECT_EQ(Find("test.disabled").acquisitions, 0);
+}
+
+TEST(ProfiledMutexTest, SharedByName) {
+    const int n_threads = 4, n_ops = 10000;
+    LockProfile::Enable(true);
+    {
+        // Both locks report into the same profile
+        ProfiledMutex<AdaptiveMutex> first("test.shared"), second("test.shared");
+        vector<thread> threads;
+        for (int i = 0; i < n_threads; i++) {
+            threads.emplace_back([&first, &second, i] {
+                auto &mutex = i % 2 == 0 ? first : second;
+                for (int j = 0; j < n_ops; j++) {
+                    std::lock_guard<ProfiledMutex<AdaptiveMutex>> lock(mutex);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+    LockProfile::Enable(false);
+
+    // Threads have exited, so all counters come from the retired shards
+    auto snapshot = Find("test.shared");
+    EXPECT_EQ(snapshot.acquisitions, n_threads * n_ops);
+    EXPECT_LE(snapshot.contended, snapshot.acquisitions);
+
+    uint64_t holds = 0, waits = 0;
+    for (size_t i = 0; i < LockProfile::kBuckets; i++) {
+        holds += snapshot.hold_hist[i];
+        waits += snapshot.wait_hist[i];
+    }
+    EXPECT_EQ(holds, snapshot.acquisitions);
+    EXPECT_EQ(waits, snapshot.contended);
+}
+
+TEST(ProfiledMutexTest, WaitAndHoldTime) {
+    ProfiledMutex<> mutex("test.timing");
+    LockProfile::Enable(true);
+
+    mutex.lock();
+    atomic<bool> started(false);
+    thread waiter([&] {
+        started = true;
+        std::lock_guard<ProfiledMutex<>> lock(mutex);
+    });
+    while (!started) {
+        this_thread::yield();
+    }
+    this_thread::sleep_for(chrono::milliseconds(20));
+    mutex.unlock();
+    waiter.join();
+
+    LockProfile::Enable(false);
+
+    auto snapshot = Find("test.timing");
+    EXPECT_EQ(snapshot.acquisitions, 2);
+    EXPECT_EQ(snapshot.contended, 1);
+    EXPECT_GE(snapshot.hold_ns, 20 * 1000 * 1000);
+
+    // 20ms hold falls into [2^24, 2^25) nanoseconds bucket or above
+    EXPECT_GE(LockProfile::Snapshot::Percentile(snapshot.hold_hist, 0.99), uint64_t(1) << 25);
+    EXPECT_GE(LockProfile::Snapshot::Percentile(snapshot.wait_hist, 0.5), uint64_t(1) << 25);
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/MPMCQueue.h>
+#include <afina/concurrency/SPSCQueue.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+// Element carries producer id in the high bits and its sequence number in the low ones
+static inline uint64_t Encode(uint64_t producer, uint64_t seq) { return (producer << 32) | seq; }
+static inline uint64_t Producer(uint64_t value) { return value >> 32; }
+static inline uint64_t Seq(uint64_t value) { return value & 0xFFFFFFFF; }
+
+TEST(QueueTest, MPMCFullAndEmpty) {
+    MPMCQueue<unique_ptr<int>> queue(3);
+    EXPECT_EQ(queue.Capacity(), 4);
+
+    unique_ptr<int> value;
+    EXPECT_FALSE(queue.TryPop(value));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.TryPush(unique_ptr<int>(new int(i))));
+    }
+    unique_ptr<int> extra(new int(4));
+    EXPECT_FALSE(queue.TryPush(std::move(extra)));
+    EXPECT_NE(extra, nullptr);
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(*value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(QueueTest, MPMCBatch) {
+    MPMCQueue<int> queue(8);
+    int in[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    int out[10];
+
+    EXPECT_EQ(queue.TryPushBatch(in, 5), 5);
+    EXPECT_EQ(queue.TryPushBatch(in + 5, 5), 3);
+    EXPECT_EQ(queue.TryPopBatch(out, 2), 2);
+    EXPECT_EQ(queue.TryPushBatch(in + 8, 2), 2);
+    EXPECT_EQ(queue.TryPopBatch(out + 2, 10), 8);
+    EXPECT_EQ(queue.TryPopBatch(out, 10), 0);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(out[i], i);
+    }
+}
+
+// Every element must be taken exactly once, and elements of the same producer must come to each consumer
+// in the order they were pushed
+static void StressMPMC(std::size_t batch) {
+    const std::size_t n_producers = 4, n_consumers = 4, n_items = 100000;
+    MPMCQueue<uint64_t> queue(64);
+    vector<atomic<int>> seen(n_producers * n_items);
+    atomic<std::size_t> taken(0);
+    atomic<bool> ordered(true);
+
+    vector<thread> threads;
+    for (std::size_t p = 0; p < n_producers; p++) {
+        threads.emplace_back([&, p] {
+            vector<uint64_t> values(batch);
+            for (std::size_t i = 0; i < n_items;) {
+                std::size_t n = std::min(batch, n_items - i);
+                for (std::size_t j = 0; j < n; j++) {
+                    values[j] = Encode(p, i + j);
+                }
+                std::size_t pushed = batch == 1 ? queue.TryPush(values[0]) : queue.TryPushBatch(values.data(), n);
+                if (pushed == 0) {
+                    this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+    }
+    for (std::size_t c = 0; c < n_consumers; c++) {
+        threads.emplace_back([&] {
+            vector<uint64_t> last(n_producers, 0);
+            vector<uint64_t> values(batch);
+            while (taken.load() < n_producers * n_items) {
+                std::size_t n = batch == 1 ? queue.TryPop(values[0]) : queue.TryPopBatch(values.data(), batch);
+                if (n == 0) {
+                    this_thread::yield();
+                }
+                for (std::size_t j = 0; j < n; j++) {
+                    uint64_t p = Producer(values[j]), seq = Seq(values[j]);
+                    if (seq + 1 <= last[p]) {
+                        ordered = false;
+                    }
+                    last[p] = seq + 1;
+                    seen[p * n_items + seq]++;
+                }
+                taken += n;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    EXPECT_TRUE(ordered.load());
+    for (auto &s : seen) {
+        ASSERT_EQ(s.load(), 1);
+    }
+}
+
+TEST(QueueTest, MPMCStress) { StressMPMC(1); }
+
+TEST(QueueTest, MPMCStressBatch) { StressMPMC(16); }
+
+TEST(QueueTest, SPSCStress) {
+    const std::size_t n_items = 1000000;
+    SPSCQueue<uint64_t> queue(128);
+
+    thread producer([&] {
+        uint64_t values[8];
+        for (uint64_t i = 0; i < n_items;) {
+            // Mix single and batch pushes
+            std::size_t n = std::min<std::size_t>(i % 8 + 1, n_items - i);
+            for (std::size_t j = 0; j < n; j++) {
+                values[j] = i + j;
+            }
+            std::size_t pushed = n == 1 ? queue.TryPush(values[0]) : queue.TryPushBatch(values, n);
+            if (pushed == 0) {
+                this_thread::yield();
+            }
+            i += pushed;
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t values[5];
+    bool ordered = true;
+    while (expected < n_items) {
+        std::size_t n = expected % 2 ? queue.TryPopBatch(values, 5) : queue.TryPop(values[0]);
+        if (n == 0) {
+            this_thread::yield();
+        }
+        for (std::size_t j = 0; j < n; j++) {
+            ordered = ordered && values[j] == expected++;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue.Size(), 0);
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ShardedCounter.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+struct Value {
+    atomic<int> value{0};
+};
+
+TEST(ThreadLocalTest, PerThreadInstances) {
+    ThreadLocal<Value> local;
+    local.Get().value = 1;
+    EXPECT_EQ(local.Size(), 1);
+
+    thread t([&] {
+        // Other thread gets its own instance
+        EXPECT_EQ(local.Get().value.load(), 0);
+        local.Get().value = 2;
+        int sum = 0;
+        local.ForEach([&sum](Value &v) { sum += v.value; });
+        EXPECT_EQ(sum, 3);
+    });
+    t.join();
+
+    // Instance of the exited thread is gone
+    EXPECT_EQ(local.Size(), 1);
+    EXPECT_EQ(local.Get().value.load(), 1);
+}
+
+TEST(ThreadLocalTest, OutlivedByThread) {
+    atomic<bool> created(false), destroyed(false);
+    unique_ptr<ThreadLocal<Value>> local(new ThreadLocal<Value>());
+
+    thread t([&] {
+        local->Get().value = 1;
+        created = true;
+        while (!destroyed) {
+            this_thread::yield();
+        }
+
+        // New instance at the same address must not be mixed up with the destroyed one
+        ThreadLocal<Value> other;
+        EXPECT_EQ(other.Get().value.load(), 0);
+    });
+    while (!created) {
+        this_thread::yield();
+    }
+    local.reset();
+    destroyed = true;
+    t.join();
+}
+
+TEST(ThreadLocalTest, ShardedCounter) {
+    const int n_threads = 8, n_ops = 100000;
+    ShardedCounter counter;
+
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < n_ops; j++) {
+                counter.Add();
+            }
+        });
+    }
+
+    // Counter could be read while threads are running and exiting
+    uint64_t last = 0;
+    for (int i = 0; i < 100; i++) {
+        uint64_t value = counter.Read();
+        EXPECT_GE(value, last);
+        last = value;
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+    counter.Add(5);
+    EXPECT_EQ(counter.Read(), n_threads * n_ops + 5);
+}
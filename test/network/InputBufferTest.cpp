@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+#include <unistd.h>
+
+#include <afina/execute/Command.h>
+
+#include <network/InputBuffer.h>
+#include <protocol/Parser.h>
+
+using namespace Afina::Network;
+
+// Reads everything buffer has in one string, chunk by chunk
+template <std::size_t N> static std::string Drain(InputBuffer<N> &buffer) {
+    std::string result;
+    while (!buffer.Empty()) {
+        result.append(buffer.Data(), buffer.Chunk());
+        buffer.Consume(buffer.Chunk());
+    }
+    return result;
+}
+
+TEST(InputBufferTest, ReadAndConsume) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    InputBuffer<16> buffer;
+    ASSERT_EQ(5, write(fds[1], "hello", 5));
+    ASSERT_EQ(5, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(5, buffer.Size());
+    EXPECT_EQ(5, buffer.Chunk());
+    EXPECT_EQ("hello", std::string(buffer.Data(), buffer.Chunk()));
+
+    buffer.Consume(2);
+    EXPECT_EQ("llo", std::string(buffer.Data(), buffer.Chunk()));
+
+    // Empty buffer starts from the beginning again
+    buffer.Consume(3);
+    EXPECT_TRUE(buffer.Empty());
+    ASSERT_EQ(3, write(fds[1], "abc", 3));
+    ASSERT_EQ(3, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(3, buffer.Chunk());
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(InputBufferTest, WrapAround) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    InputBuffer<16> buffer;
+    ASSERT_EQ(12, write(fds[1], "0123456789ab", 12));
+    ASSERT_EQ(12, buffer.ReadFrom(fds[0]));
+    buffer.Consume(10);
+
+    // Single read fills the tail of the storage and then its head
+    ASSERT_EQ(12, write(fds[1], "cdefghijklmn", 12));
+    ASSERT_EQ(12, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(14, buffer.Size());
+    EXPECT_EQ(6, buffer.Chunk());
+    EXPECT_EQ("abcdefghijklmn", Drain(buffer));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(InputBufferTest, Full) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    InputBuffer<4> buffer;
+    ASSERT_EQ(6, write(fds[1], "abcdef", 6));
+    ASSERT_EQ(4, buffer.ReadFrom(fds[0]));
+    EXPECT_TRUE(buffer.Full());
+
+    errno = 0;
+    EXPECT_EQ(-1, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(ENOBUFS, errno);
+
+    buffer.Consume(1);
+    EXPECT_EQ(1, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ("bcde", Drain(buffer));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// Pipeline longer than the buffer, commands are split by the end of the storage
+TEST(InputBufferTest, ParsePipeline) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    std::string input;
+    for (int i = 0; i < 100; i++) {
+        input += "set key" + std::to_string(i) + " 0 0 5\r\nvalue\r\n";
+    }
+    ASSERT_EQ(input.size(), write(fds[1], input.data(), input.size()));
+    close(fds[1]);
+
+    InputBuffer<64> buffer;
+    Afina::Protocol::Parser parser;
+    std::size_t arg_remains = 0, commands = 0;
+    std::string argument;
+    bool command = false;
+    while (buffer.ReadFrom(fds[0]) > 0) {
+        while (!buffer.Empty()) {
+            if (!command) {
+                std::size_t parsed = 0;
+                if (parser.Parse(buffer.Data(), buffer.Chunk(), parsed)) {
+                    command = parser.Build(arg_remains) != nullptr;
+                    arg_remains += 2;
+                }
+                ASSERT_GT(parsed, 0);
+                buffer.Consume(parsed);
+            }
+
+            if (command && arg_remains > 0) {
+                std::size_t to_read = std::min(arg_remains, buffer.Chunk());
+                argument.append(buffer.Data(), to_read);
+                buffer.Consume(to_read);
+                arg_remains -= to_read;
+            }
+
+            if (command && arg_remains == 0) {
+                EXPECT_EQ("value\r\n", argument);
+                commands++;
+                command = false;
+                argument.clear();
+                parser.Reset();
+            }
+        }
+    }
+    EXPECT_EQ(100, commands);
+    close(fds[0]);
+}
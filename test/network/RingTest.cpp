@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <network/uring/Ring.h>
+
+using namespace Afina::Network::Uring;
+
+// Kernel without io_uring (or with it disabled) has nothing to check
+static bool Available() {
+    try {
+        Ring ring(4);
+        return true;
+    } catch (std::runtime_error &) {
+        return false;
+    }
+}
+
+// Server falls back to mt_nonblock silently if probe fails, so make sure it doesn't whenever it could pass
+TEST(RingTest, Supported) {
+    if (!Available()) {
+        return;
+    }
+    EXPECT_TRUE(Ring::Supported());
+}
+
+// Each recv takes the next provided buffer, recycled buffers come back in order of recycling
+TEST(RingTest, ProvidedBuffersRecycle) {
+    if (!Available()) {
+        return;
+    }
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds));
+
+    Ring ring(4);
+    ring.SetupBuffers(7, 2, 16);
+
+    // More recvs than buffers, so every buffer goes through the ring tail wrap
+    for (int i = 0; i < 5; i++) {
+        std::string message = "message " + std::to_string(i);
+        ASSERT_EQ(message.size(), write(fds[1], message.data(), message.size()));
+
+        struct io_uring_sqe *sqe = ring.GetSqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fds[0];
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 7;
+        sqe->user_data = i;
+        ASSERT_GE(ring.Submit(1), 0);
+
+        struct io_uring_cqe *cqe = ring.PeekCqe();
+        ASSERT_NE(nullptr, cqe);
+        EXPECT_EQ(i, cqe->user_data);
+        ASSERT_EQ(int(message.size()), cqe->res);
+        ASSERT_TRUE(cqe->flags & IORING_CQE_F_BUFFER);
+
+        uint16_t bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        EXPECT_EQ(i % 2, bid);
+        EXPECT_EQ(message, std::string(ring.Buffer(bid), cqe->res));
+        ring.Advance(1);
+        ring.RecycleBuffer(bid);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
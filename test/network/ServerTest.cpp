@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <afina/logging/Config.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Network;
+
+// Loggers are registered globally, so service is started once for all tests
+static std::shared_ptr<Logging::Service> Logs() {
+    static std::shared_ptr<Logging::Service> service = [] {
+        std::shared_ptr<Logging::Config> config(new Logging::Config);
+        config->appenders["console"].type = Logging::Appender::Type::STDERR;
+        config->appenders["console"].color = false;
+
+        Logging::Logger &logger = config->loggers["root"];
+        logger.level = Logging::Logger::Level::CRITICAL;
+        logger.appenders.push_back("console");
+        logger.format = "%v";
+
+        std::shared_ptr<Logging::Service> result(new Logging::ServiceImpl(config));
+        result->Start();
+        return result;
+    }();
+    return service;
+}
+
+// Connects to the server on loopback, returns -1 on failure
+static int Connect(uint16_t port) {
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT_GE(client, 0);
+
+    struct timeval timeout = {5, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (connect(client, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(client);
+        return -1;
+    }
+    return client;
+}
+
+// Sends request, closes the write side and reads everything server replies until it closes connection
+static std::string HalfClose(uint16_t port, const std::string &request) {
+    int client = Connect(port);
+
+    std::string reply;
+    if (client >= 0 && send(client, request.data(), request.size(), MSG_NOSIGNAL) == ssize_t(request.size())) {
+        shutdown(client, SHUT_WR);
+
+        char buffer[1024];
+        ssize_t n;
+        while ((n = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+            reply.append(buffer, n);
+        }
+    }
+    if (client >= 0) {
+        close(client);
+    }
+    return reply;
+}
+
+static void CheckHalfClose(MTnonblock::ServerImpl::Mode mode, uint16_t port) {
+    std::shared_ptr<Afina::Storage> storage(new Backend::SimpleLRU(1024));
+    MTnonblock::ServerImpl server(storage, Logs(), mode);
+    server.Start(port, 1, 2);
+
+    // Client closing its side right after the request still gets every result
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ("STORED\r\nVALUE a 0 1\r\nx\r\nEND\r\n", HalfClose(port, "set a 0 0 1\r\nx\r\nget a\r\n"));
+    }
+
+    server.Stop();
+    server.Join();
+}
+
+TEST(ServerTest, HalfCloseShared) { CheckHalfClose(MTnonblock::ServerImpl::Mode::kShared, 18081); }
+
+TEST(ServerTest, HalfCloseReusePort) { CheckHalfClose(MTnonblock::ServerImpl::Mode::kReusePort, 18082); }
+
+TEST(ServerTest, HalfCloseHandOff) { CheckHalfClose(MTnonblock::ServerImpl::Mode::kHandOff, 18083); }
+
+// Idle connections owned by workers are closed once server is joined, not leaked
+TEST(ServerTest, StopClosesHandOff) {
+    std::shared_ptr<Afina::Storage> storage(new Backend::SimpleLRU(1024));
+    MTnonblock::ServerImpl server(storage, Logs(), MTnonblock::ServerImpl::Mode::kHandOff);
+    server.Start(18084, 1, 2);
+
+    std::vector<int> clients;
+    for (int i = 0; i < 4; i++) {
+        int client = Connect(18084);
+        ASSERT_GE(client, 0);
+        clients.push_back(client);
+    }
+
+    // Make sure each connection got to the worker
+    for (int client : clients) {
+        std::string request = "set a 0 0 1\r\nx\r\n";
+        ASSERT_EQ(ssize_t(request.size()), send(client, request.data(), request.size(), MSG_NOSIGNAL));
+        char buffer[16];
+        EXPECT_EQ(8, recv(client, buffer, sizeof(buffer), 0));
+    }
+
+    server.Stop();
+    server.Join();
+
+    // Server closed first, client resets connection, so that server port isn't left in TIME_WAIT
+    for (int client : clients) {
+        char buffer[16];
+        EXPECT_EQ(0, recv(client, buffer, sizeof(buffer), 0));
+
+        struct linger abort = {1, 0};
+        setsockopt(client, SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+        close(client);
+    }
+}
@@ -1,18 +1,31 @@
 #include "gtest/gtest.h"
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <random>
 #include <set>
+#include <thread>
 #include <vector>
 
+#include <afina/concurrency/Epoch.h>
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/FlatCombineLRU.h"
+#include "storage/HashIndex.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SimpleClock.h"
 #include "storage/SimpleLRU.h"
+#include "storage/SwissIndex.h"
+#include "storage/ThreadSafeClock.h"
+#include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina::Backend;
+using namespace Afina::Concurrency;
 using namespace Afina::Execute;
 using namespace std;
 
@@ -58,9 +71,12 @@ std::string pad_space(const std::string &s, size_t length) {
     return result;
 }
 
+// Budget taken by an item with key and value of the given sizes
+static size_t ItemCharge(size_t key_size, size_t value_size) { return SimpleLRU().Charge(key_size, value_size); }
+
 TEST(StorageTest, BigTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 100000 * length);
+    SimpleLRU storage(100000 * ItemCharge(length, length));
 
     for (long i = 0; i < 100000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
@@ -81,7 +97,7 @@ TEST(StorageTest, BigTest) {
 
 TEST(StorageTest, MaxTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 1000 * length);
+    SimpleLRU storage(1000 * ItemCharge(length, length));
 
     std::stringstream ss;
 
@@ -108,3 +124,433 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, ShardedPutGet) {
+    ShardedLRU storage(4, 2 * 1000 * 20);
+
+    for (long i = 0; i < 100; ++i) {
+        storage.Put("Key " + std::to_string(i), "Val " + std::to_string(i));
+    }
+
+    for (long i = 0; i < 100; ++i) {
+        std::string res;
+        EXPECT_TRUE(storage.Get("Key " + std::to_string(i), res));
+        EXPECT_TRUE(res == "Val " + std::to_string(i));
+    }
+
+    EXPECT_FALSE(storage.PutIfAbsent("Key 1", "other"));
+    EXPECT_TRUE(storage.Set("Key 1", "other"));
+    EXPECT_TRUE(storage.Delete("Key 1"));
+
+    std::string res;
+    EXPECT_FALSE(storage.Get("Key 1", res));
+    EXPECT_FALSE(storage.Set("Key 1", "other"));
+}
+
+TEST(StorageTest, ShardedConcurrentPutGet) {
+    const size_t length = 20;
+    const long n_threads = 4, n_keys = 1000;
+    ShardedLRU storage(8, 2 * n_threads * n_keys * ItemCharge(length, length));
+
+    std::vector<std::thread> threads;
+    for (long t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&storage, t, n_keys, length] {
+            for (long i = 0; i < n_keys; ++i) {
+                auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+                auto val = pad_space("Val " + std::to_string(t) + " " + std::to_string(i), length);
+                storage.Put(key, val);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (long t = 0; t < n_threads; ++t) {
+        for (long i = 0; i < n_keys; ++i) {
+            auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+            auto val = pad_space("Val " + std::to_string(t) + " " + std::to_string(i), length);
+
+            std::string res;
+            EXPECT_TRUE(storage.Get(key, res));
+            EXPECT_TRUE(val == res);
+        }
+    }
+}
+
+TEST(StorageTest, FlatCombineConcurrentPutGet) {
+    const size_t length = 20;
+    const long n_threads = 4, n_keys = 1000;
+    FlatCombineLRU storage(2 * n_threads * n_keys * ItemCharge(length, length));
+
+    // All threads also hit the same hot key, its value must be one of written ones
+    auto hot = pad_space("Hot", length);
+    std::vector<std::thread> threads;
+    for (long t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&storage, &hot, t, n_keys, length] {
+            std::string res;
+            for (long i = 0; i < n_keys; ++i) {
+                auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+                auto val = pad_space("Val " + std::to_string(t) + " " + std::to_string(i), length);
+                storage.Put(key, val);
+                storage.Put(hot, val);
+                storage.Get(hot, res);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (long t = 0; t < n_threads; ++t) {
+        for (long i = 0; i < n_keys; ++i) {
+            auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+            auto val = pad_space("Val " + std::to_string(t) + " " + std::to_string(i), length);
+
+            std::string res;
+            EXPECT_TRUE(storage.Get(key, res));
+            EXPECT_TRUE(val == res);
+        }
+    }
+
+    std::string res;
+    EXPECT_TRUE(storage.Get(hot, res));
+    EXPECT_EQ(res.substr(0, 4), "Val ");
+}
+
+struct index_node {
+    std::string key;
+};
+
+struct index_node_equal {
+    bool operator()(const index_node &n, const std::string &key) const { return n.key == key; }
+};
+
+// Applies random inserts/deletes to the index and checks it against std::map
+template <typename Index> void CheckIndex() {
+    Index index;
+    std::map<std::string, std::unique_ptr<index_node>> expected;
+    std::hash<std::string> hasher;
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> key_dist(0, 5000);
+    for (long i = 0; i < 100000; ++i) {
+        auto key = "Key " + std::to_string(key_dist(gen));
+        auto it = expected.find(key);
+        index_node *found = index.Find(key, hasher(key));
+
+        ASSERT_EQ(found, it == expected.end() ? nullptr : it->second.get());
+        if (it == expected.end()) {
+            std::unique_ptr<index_node> n{new index_node{key}};
+            index.Insert(n.get(), hasher(key));
+            expected.emplace(key, std::move(n));
+        } else if (i % 2 == 0) {
+            EXPECT_EQ(index.Erase(key, hasher(key)), it->second.get());
+            expected.erase(it);
+        }
+        ASSERT_EQ(index.Size(), expected.size());
+    }
+
+    for (auto &e : expected) {
+        EXPECT_EQ(index.Find(e.first, hasher(e.first)), e.second.get());
+    }
+}
+
+TEST(StorageTest, HashIndexRandom) { CheckIndex<HashIndex<index_node, index_node_equal>>(); }
+
+TEST(StorageTest, SwissIndexRandom) { CheckIndex<SwissIndex<index_node, index_node_equal>>(); }
+
+TEST(StorageTest, SwissIndexScalarRandom) {
+    CheckIndex<SwissIndex<index_node, index_node_equal, SwissGroupScalar>>();
+}
+
+TEST(StorageTest, DeleteTail) {
+    SimpleLRU storage;
+
+    storage.Put("KEY1", "val1");
+    storage.Put("KEY2", "val2");
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    storage.Put("KEY3", "val3");
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(value == "val3");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+}
+
+TEST(StorageTest, PutResizeValue) {
+    // Room for a few small items or for a single big one
+    SimpleLRU storage(ItemCharge(4, 100));
+
+    storage.Put("KEY1", "val1");
+    storage.Put("KEY2", "val2");
+    storage.Put("KEY1", "longer value");
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "longer value");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+
+    // KEY1 is the oldest one now, but it must survive own update
+    storage.Put("KEY1", std::string(100, 'w'));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == std::string(100, 'w'));
+
+    EXPECT_FALSE(storage.Put("KEY1", std::string(200, 'w')));
+}
+
+TEST(StorageTest, EvictAll) {
+    SimpleLRU storage(2 * ItemCharge(2, 2));
+
+    // Value is large enough to need room of both items
+    std::string big(40, 'x');
+    ASSERT_GT(ItemCharge(2, big.size()), ItemCharge(2, 2));
+    ASSERT_LE(ItemCharge(2, big.size()), 2 * ItemCharge(2, 2));
+
+    storage.Put("K1", "v1");
+    storage.Put("K2", "v2");
+    EXPECT_TRUE(storage.Put("K3", big));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("K1", value));
+    EXPECT_FALSE(storage.Get("K2", value));
+    EXPECT_TRUE(storage.Get("K3", value));
+    EXPECT_TRUE(value == big);
+}
+
+TEST(StorageTest, ClockSecondChance) {
+    SimpleClock storage(3 * ItemCharge(4, 4));
+
+    storage.Put("KEY1", "val1");
+    storage.Put("KEY2", "val2");
+    storage.Put("KEY3", "val3");
+
+    // KEY1 is the oldest one, but it is referenced so KEY2 goes away instead
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    storage.Put("KEY4", "val4");
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+
+    // All items are referenced now, so eviction makes full circle and takes the first one in
+    // the clock order: KEY3, as KEY1 has been moved behind it
+    storage.Put("KEY5", "val5");
+    EXPECT_FALSE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY5", value));
+}
+
+TEST(StorageTest, ClockGrowReferenced) {
+    SimpleClock storage(3 * ItemCharge(1, 4));
+
+    storage.Put("A", "valA");
+    storage.Put("B", "valB");
+    storage.Put("F", "valF");
+
+    // Referenced items go behind F, still F itself must not be evicted to make room for its own value
+    std::string value;
+    EXPECT_TRUE(storage.Get("A", value));
+    EXPECT_TRUE(storage.Get("B", value));
+    std::string big(40, 'f');
+    ASSERT_GT(ItemCharge(1, big.size()), ItemCharge(1, 4));
+    EXPECT_TRUE(storage.Put("F", big));
+
+    EXPECT_TRUE(storage.Get("F", value));
+    EXPECT_TRUE(value == big);
+    EXPECT_FALSE(storage.Get("A", value));
+    EXPECT_TRUE(storage.Get("B", value));
+}
+
+TEST(StorageTest, ClockConcurrentGet) {
+    const size_t length = 20;
+    const long n_threads = 4, n_keys = 1000;
+    ThreadSafeClock storage(n_keys * ItemCharge(length, length));
+
+    for (long i = 0; i < n_keys; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    std::vector<std::thread> threads;
+    for (long t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&storage, t, n_keys, length] {
+            for (long i = 0; i < n_keys; ++i) {
+                auto key = pad_space("Key " + std::to_string(i), length);
+                if (i % n_threads == t) {
+                    // Update value of the same size, so nothing gets evicted
+                    storage.Put(key, pad_space("New " + std::to_string(i), length));
+                } else {
+                    std::string res;
+                    EXPECT_TRUE(storage.Get(key, res));
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (long i = 0; i < n_keys; ++i) {
+        std::string res;
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+        EXPECT_TRUE(res == pad_space("New " + std::to_string(i), length));
+    }
+}
+
+TEST(StorageTest, ExpiredPut) {
+    SimpleLRU storage;
+    std::time_t now = std::time(nullptr);
+
+    storage.Put("KEY1", "val1", now + 1000);
+    storage.Put("KEY2", "val2");
+    storage.Put("KEY2", "val2", now - 1);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2", now + 1000));
+    EXPECT_FALSE(storage.Set("KEY3", "val3", now + 1000));
+}
+
+TEST(StorageTest, PutKeepExpire) {
+    SimpleLRU storage;
+    std::time_t now = std::time(nullptr);
+
+    storage.Put("KEY1", "val1", now + 1000);
+    storage.Put("KEY1", "val1+", Afina::Storage::kKeepExpire);
+    storage.Put("KEY2", "val2", Afina::Storage::kKeepExpire);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1+");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+
+    // Rewritten value still expires at the original deadline
+    storage.Put("KEY3", "val3", now + 1);
+    storage.Put("KEY3", "val3+", Afina::Storage::kKeepExpire);
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+}
+
+TEST(StorageTest, ExpireCrawler) {
+    const size_t length = 20;
+    const long n_keys = 1000;
+    ThreadSafeSimplLRU storage(n_keys * ItemCharge(length, length));
+
+    std::time_t deadline = std::time(nullptr) + 1;
+    for (long i = 0; i < n_keys; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        storage.Put(key, pad_space("Val " + std::to_string(i), length), i % 2 == 0 ? deadline : 0);
+    }
+
+    storage.Start();
+    while (std::time(nullptr) <= deadline + 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    storage.Stop();
+
+    // Crawler has already removed everything expired
+    EXPECT_EQ(storage.Expire(4 * n_keys), 0);
+    for (long i = 0; i < n_keys; ++i) {
+        std::string res;
+        EXPECT_EQ(storage.Get(pad_space("Key " + std::to_string(i), length), res), i % 2 != 0);
+    }
+}
+
+/**
+ * Storage which reports memory taken from the system
+ */
+class FootprintLRU : public SimpleLRU {
+public:
+    FootprintLRU(size_t max_size) : SimpleLRU(max_size) {}
+
+    size_t Footprint() const { return _allocator.Footprint(); }
+    size_t PageSize() const { return _allocator.PageSize(); }
+};
+
+TEST(StorageTest, PageReassignment) {
+    const size_t budget = 4 * 1024 * 1024, small = 100, large = 2000;
+    FootprintLRU storage(budget);
+
+    // Small values take whole budget, every 8th of them stays hot
+    const long n_small = budget / storage.Charge(10, small);
+    for (long i = 0; i < n_small; ++i) {
+        storage.Put(pad_space("S" + std::to_string(i), 10), std::string(small, 's'));
+    }
+
+    // Workload moves to large values, while hot small items are spread over all pages of their class
+    std::string res;
+    for (long i = 0; i < long(4 * budget / large); ++i) {
+        if (i % 256 == 0) {
+            for (long j = 0; j < n_small; j += 8) {
+                storage.Get(pad_space("S" + std::to_string(j), 10), res);
+            }
+        }
+        EXPECT_TRUE(storage.Put(pad_space("L" + std::to_string(i), 10), std::string(large, 'l')));
+    }
+
+    // Large class takes pages of the small one instead of growing beyond the budget
+    EXPECT_LE(storage.Footprint(), budget + 8 * storage.PageSize());
+    EXPECT_TRUE(storage.Get(pad_space("L" + std::to_string(4 * budget / large - 1), 10), res));
+}
+
+/**
+ * Storage which frees removed items only once readers pinned before removal are gone
+ */
+class EpochLRU : public SimpleLRU {
+public:
+    EpochLRU(size_t max_size) : SimpleLRU(max_size) {}
+
+    // Released items go back to the allocator, so it is guarded by the same lock as storage
+    std::mutex mutex;
+
+    // Declared after mutex, as it frees the rest of items on destruction
+    EpochDomain domain;
+
+protected:
+    void ReleaseItem(Item *item) override { domain.Retire(item, FreeItem, this); }
+
+private:
+    static void FreeItem(void *item, void *storage) {
+        EpochLRU *self = static_cast<EpochLRU *>(storage);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        Item::Destroy(self->_allocator, static_cast<Item *>(item));
+    }
+};
+
+TEST(StorageTest, EpochDeferredRelease) {
+    EpochLRU storage(ItemCharge(4, 60));
+    {
+        std::lock_guard<std::mutex> lock(storage.mutex);
+        storage.Put("KEY1", std::string(60, 'a'));
+    }
+
+    {
+        auto guard = storage.domain.Pin();
+        {
+            // Evicts KEY1, but its memory is still there
+            std::lock_guard<std::mutex> lock(storage.mutex);
+            storage.Put("KEY2", std::string(60, 'b'));
+        }
+        EXPECT_EQ(storage.domain.Pending(), 1);
+        storage.domain.Collect();
+        EXPECT_EQ(storage.domain.Pending(), 1);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        storage.domain.Collect();
+    }
+    EXPECT_EQ(storage.domain.Pending(), 0);
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+}